@@ -368,7 +368,8 @@ Core::initiateMemoryAccess(MemComponent::component_t mem_component,
                mem_op_type,
                curr_addr_aligned, curr_offset,
                data_buf ? curr_data_buffer_head : NULL, curr_size,
-               modeled);
+               modeled,
+               eip);
 /*
       if(strcmp(HitWhereString(this_hit_where),"L1")!=0 && strcmp(HitWhereString(this_hit_where),"L1I")!=0 && strcmp(HitWhereString(this_hit_where),"L2")!=0 && strcmp(HitWhereString(this_hit_where),"dram-local")){
 cout << "in core.h initiateMemoryAccess() HitWhere::where_t is: " << HitWhereString(this_hit_where) << endl;
@@ -1,4 +1,5 @@
 #include "address_home_lookup.h"
+#include "hmc_address_map.h"
 #include "log.h"
 #include <iostream>
 
@@ -9,7 +10,9 @@ AddressHomeLookup::AddressHomeLookup(UInt32 ahl_param,
    m_ahl_param(ahl_param),
    m_ahl_mask((UInt64(1) << ahl_param) - 1),
    m_core_list(core_list),
-   m_cache_block_size(cache_block_size)
+   m_cache_block_size(cache_block_size),
+   m_hmc_map(NULL),
+   m_vaults_per_module(1)
 {
 
    // Each Block Address is as follows:
@@ -22,6 +25,16 @@ AddressHomeLookup::AddressHomeLookup(UInt32 ahl_param,
          m_ahl_param, m_cache_block_size);
    m_total_modules = core_list.size();
 
+   if (HmcAddressMap::getSingleton()->isEnabled())
+   {
+      m_hmc_map = HmcAddressMap::getSingleton();
+      LOG_ASSERT_ERROR(m_hmc_map->getOffsetBits() >= m_ahl_param,
+            "HMC vault interleaving granularity (2^%u) must be >= 2^AHL param(%u)",
+            m_hmc_map->getOffsetBits(), m_ahl_param);
+      // Each module owns every m_total_modules'th vault
+      m_vaults_per_module = (m_hmc_map->getTotalVaults() + m_total_modules - 1) / m_total_modules;
+   }
+
 //   cout << "[LINGXI]: in /common/core/mem_sub/ahl.cc. m_ahl_param: " << to_string(m_ahl_param) << " m_cache_block_size: " << to_string(m_cache_block_size) << endl;
 
 }
@@ -34,7 +47,9 @@ AddressHomeLookup::~AddressHomeLookup()
 
 core_id_t AddressHomeLookup::getHome(IntPtr address) const
 {
-   SInt32 module_num = (address >> m_ahl_param) % m_total_modules;
+   SInt32 module_num = m_hmc_map
+      ? m_hmc_map->getGlobalVault(address) % m_total_modules
+      : (address >> m_ahl_param) % m_total_modules;
    LOG_ASSERT_ERROR(0 <= module_num && module_num < (SInt32) m_total_modules, "module_num(%i), total_modules(%u)", module_num, m_total_modules);
 
    LOG_PRINT("address(0x%x), module_num(%i)", address, module_num);
@@ -43,7 +58,11 @@ core_id_t AddressHomeLookup::getHome(IntPtr address) const
 
 IntPtr AddressHomeLookup::getLinearBlock(IntPtr address) const
 {
-   return (address >> m_ahl_param) / m_total_modules;
+   if (m_hmc_map)
+      return (m_hmc_map->getVaultLocalAddress(address) >> m_ahl_param) * m_vaults_per_module
+         + m_hmc_map->getGlobalVault(address) / m_total_modules;
+   else
+      return (address >> m_ahl_param) / m_total_modules;
 }
 
 IntPtr AddressHomeLookup::getLinearAddress(IntPtr address) const
@@ -5,6 +5,8 @@
 
 #include "fixed_types.h"
 
+class HmcAddressMap;
+
 /*
  * TODO abstract MMU stuff to a configure file to allow
  * user to specify number of memory controllers, and
@@ -38,6 +40,9 @@ class AddressHomeLookup
       std::vector<core_id_t> m_core_list;
       UInt32 m_total_modules;
       UInt32 m_cache_block_size;
+      // When HMC address mapping is enabled, homes are assigned per vault rather than per ahl_param-sized chunk
+      const HmcAddressMap* m_hmc_map;
+      UInt32 m_vaults_per_module;
 };
 
 #endif /* __ADDRESS_HOME_LOOKUP_H__ */
@@ -22,6 +22,7 @@ Cache::Cache(
    m_num_accesses(0),
    m_num_hits(0),
    m_cache_type(cache_type),
+   m_replacement_policy(CacheSet::parsePolicyType(replacement_policy)),
    m_fault_injector(fault_injector)
 {
    m_set_info = CacheSet::createCacheSetInfo(name, cfgname, core_id, replacement_policy, m_associativity);
@@ -36,6 +37,8 @@ Cache::Cache(
    for (UInt32 i = 0; i < m_num_sets; i++)
       m_set_usage_hist[i] = 0;
    #endif
+
+   Sim()->getCheckpointManager()->registerObject(name, core_id, this);
 }
 
 Cache::~Cache()
@@ -184,3 +187,43 @@ Cache::updateHits(Core::mem_op_t mem_op_type, UInt64 hits)
       m_num_hits += hits;
    }
 }
+
+void
+Cache::saveCheckpoint(CheckpointWriter &writer)
+{
+   if (!Sim()->isTimingOnlyMemory())
+      LOG_PRINT_WARNING_ONCE("Checkpoints do not contain cache line data, only tags and state");
+
+   writer.write(m_num_sets);
+   writer.write(m_associativity);
+   writer.write(m_blocksize);
+   writer.write(UInt32(m_replacement_policy));
+   for (UInt32 i = 0; i < m_num_sets; i++)
+      m_sets[i]->saveCheckpoint(writer);
+}
+
+bool
+Cache::restoreCheckpoint(CheckpointReader &reader)
+{
+   if (reader.read<UInt32>() != m_num_sets || reader.read<UInt32>() != m_associativity
+      || reader.read<UInt32>() != m_blocksize || reader.read<UInt32>() != UInt32(m_replacement_policy))
+      return false;
+
+   // Sets are restored one at a time, keep their current state to undo a partially restored cache
+   std::vector<char> backup;
+   CheckpointWriter backup_writer(backup);
+   for (UInt32 i = 0; i < m_num_sets; i++)
+      m_sets[i]->saveCheckpoint(backup_writer);
+
+   for (UInt32 i = 0; i < m_num_sets; i++)
+   {
+      if (!m_sets[i]->restoreCheckpoint(reader))
+      {
+         CheckpointReader backup_reader(m_name + ".backup", backup);
+         for (UInt32 j = 0; j <= i; j++)
+            m_sets[j]->restoreCheckpoint(backup_reader);
+         return false;
+      }
+   }
+   return true;
+}
@@ -11,11 +11,12 @@
 #include "log.h"
 #include "core.h"
 #include "fault_injection.h"
+#include "checkpoint_manager.h"
 
 // Define to enable the set usage histogram
 //#define ENABLE_SET_USAGE_HIST
 
-class Cache : public CacheBase
+class Cache : public CacheBase, public Checkpointable
 {
    private:
       bool m_enabled;
@@ -26,6 +27,7 @@ class Cache : public CacheBase
 
       // Generic Cache Info
       cache_t m_cache_type;
+      ReplacementPolicy m_replacement_policy;
       CacheSet** m_sets;
       CacheSetInfo* m_set_info;
 
@@ -68,6 +70,9 @@ class Cache : public CacheBase
 
       void enable() { m_enabled = true; }
       void disable() { m_enabled = false; }
+
+      void saveCheckpoint(CheckpointWriter &writer);
+      bool restoreCheckpoint(CheckpointReader &reader);
 };
 
 template <class T>
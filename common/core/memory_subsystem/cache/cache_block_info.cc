@@ -2,6 +2,7 @@
 #include "pr_l1_cache_block_info.h"
 #include "pr_l2_cache_block_info.h"
 #include "shared_cache_block_info.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 
 const char* CacheBlockInfo::option_names[] =
@@ -22,8 +23,10 @@ const char* CacheBlockInfo::getOptionName(option_t option)
 
 
 CacheBlockInfo::CacheBlockInfo(IntPtr tag, CacheState::cstate_t cstate, UInt64 options):
-   m_tag(tag),
-   m_cstate(cstate),
+   m_tag_storage(tag),
+   m_cstate_storage(cstate),
+   m_tag(&m_tag_storage),
+   m_cstate(&m_cstate_storage),
    m_owner(0),
    m_used(0),
    m_options(options)
@@ -55,20 +58,45 @@ CacheBlockInfo::create(CacheBase::cache_t cache_type)
 void
 CacheBlockInfo::invalidate()
 {
-   m_tag = ~0;
-   m_cstate = CacheState::INVALID;
+   *m_tag = ~0;
+   *m_cstate = CacheState::INVALID;
 }
 
 void
 CacheBlockInfo::clone(CacheBlockInfo* cache_block_info)
 {
-   m_tag = cache_block_info->getTag();
-   m_cstate = cache_block_info->getCState();
+   *m_tag = cache_block_info->getTag();
+   *m_cstate = cache_block_info->getCState();
    m_owner = cache_block_info->m_owner;
    m_used = cache_block_info->m_used;
    m_options = cache_block_info->m_options;
 }
 
+void
+CacheBlockInfo::saveCheckpoint(CheckpointWriter &writer) const
+{
+   writer.write(m_owner);
+   writer.write(m_used);
+   writer.write(m_options);
+}
+
+void
+CacheBlockInfo::restoreCheckpoint(CheckpointReader &reader)
+{
+   reader.read(m_owner);
+   reader.read(m_used);
+   reader.read(m_options);
+}
+
+void
+CacheBlockInfo::bindStorage(IntPtr* tag, CacheState::cstate_t* cstate)
+{
+   *tag = *m_tag;
+   *cstate = *m_cstate;
+   m_tag = tag;
+   m_cstate = cstate;
+}
+
 bool
 CacheBlockInfo::updateUsage(UInt32 offset, UInt32 size)
 {
@@ -5,6 +5,9 @@
 #include "cache_state.h"
 #include "cache_base.h"
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class CacheBlockInfo
 {
    public:
@@ -21,14 +24,26 @@ class CacheBlockInfo
    // This can be extended later to include other information
    // for different cache coherence protocols
    private:
-      IntPtr m_tag;
-      CacheState::cstate_t m_cstate;
+      // Tag and state are accessed through m_tag and m_cstate. They point to the local storage below,
+      // unless the block lives in a CacheSet which keeps all tags and states of the set in contiguous arrays
+      IntPtr m_tag_storage;
+      CacheState::cstate_t m_cstate_storage;
+      IntPtr* m_tag;
+      CacheState::cstate_t* m_cstate;
       UInt64 m_owner;
       BitsUsedType m_used;
       UInt8 m_options;  // large enough to hold a bitfield for all available option_t's
 
       static const char* option_names[];
 
+      // Copying would alias the tag and state storage
+      CacheBlockInfo(const CacheBlockInfo&);
+      CacheBlockInfo& operator=(const CacheBlockInfo&);
+
+      // Move tag and state into a CacheSet's tag and state arrays
+      void bindStorage(IntPtr* tag, CacheState::cstate_t* cstate);
+      friend class CacheSet;
+
    public:
       CacheBlockInfo(IntPtr tag = ~0,
             CacheState::cstate_t cstate = CacheState::INVALID,
@@ -40,13 +55,17 @@ class CacheBlockInfo
       virtual void invalidate(void);
       virtual void clone(CacheBlockInfo* cache_block_info);
 
-      bool isValid() const { return (m_tag != ((IntPtr) ~0)); }
+      // Everything but the tag and state, which are saved by the CacheSet
+      virtual void saveCheckpoint(CheckpointWriter &writer) const;
+      virtual void restoreCheckpoint(CheckpointReader &reader);
+
+      bool isValid() const { return (*m_tag != ((IntPtr) ~0)); }
 
-      IntPtr getTag() const { return m_tag; }
-      CacheState::cstate_t getCState() const { return m_cstate; }
+      IntPtr getTag() const { return *m_tag; }
+      CacheState::cstate_t getCState() const { return *m_cstate; }
 
-      void setTag(IntPtr tag) { m_tag = tag; }
-      void setCState(CacheState::cstate_t cstate) { m_cstate = cstate; }
+      void setTag(IntPtr tag) { *m_tag = tag; }
+      void setCState(CacheState::cstate_t cstate) { *m_cstate = cstate; }
 
       UInt64 getOwner() const { return m_owner; }
       void setOwner(UInt64 owner) { m_owner = owner; }
@@ -8,22 +8,30 @@
 #include "cache_set_round_robin.h"
 #include "cache_set_srrip.h"
 #include "cache_base.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 #include "simulator.h"
 #include "config.h"
 #include "config.hpp"
 
+#if defined(__x86_64__) && (defined(__AVX2__) || defined(__SSE2__))
+#include <immintrin.h>
+#endif
+
 CacheSet::CacheSet(CacheBase::cache_t cache_type,
       UInt32 associativity, UInt32 blocksize):
       m_associativity(associativity), m_blocksize(blocksize)
 {
    m_cache_block_info_array = new CacheBlockInfo*[m_associativity];
+   m_tags = new IntPtr[m_associativity];
+   m_cstates = new CacheState::cstate_t[m_associativity];
    for (UInt32 i = 0; i < m_associativity; i++)
    {
       m_cache_block_info_array[i] = CacheBlockInfo::create(cache_type);
+      m_cache_block_info_array[i]->bindStorage(&m_tags[i], &m_cstates[i]);
    }
 
-   if (Sim()->getFaultinjectionManager())
+   if (!Sim()->isTimingOnlyMemory())
    {
       m_blocks = new char[m_associativity * m_blocksize];
       memset(m_blocks, 0x00, m_associativity * m_blocksize);
@@ -37,6 +45,8 @@ CacheSet::~CacheSet()
    for (UInt32 i = 0; i < m_associativity; i++)
       delete m_cache_block_info_array[i];
    delete [] m_cache_block_info_array;
+   delete [] m_tags;
+   delete [] m_cstates;
    delete [] m_blocks;
 }
 
@@ -66,33 +76,67 @@ CacheSet::write_line(UInt32 line_index, UInt32 offset, Byte *in_buff, UInt32 byt
       updateReplacementIndex(line_index);
 }
 
-CacheBlockInfo*
-CacheSet::find(IntPtr tag, UInt32* line_index)
+// Return the highest way holding tag, or -1 if there is none.
+// Compares four (AVX2) or two (SSE2) tags at once, starting from the top ways, then finishes the remaining low ways one by one.
+SInt32
+CacheSet::findWay(IntPtr tag) const
 {
-   for (SInt32 index = m_associativity-1; index >= 0; index--)
+   SInt32 index = m_associativity;
+
+#if defined(__x86_64__) && defined(__AVX2__)
+   const __m256i needle = _mm256_set1_epi64x(tag);
+   while (index >= 4)
    {
-      if (m_cache_block_info_array[index]->getTag() == tag)
-      {
-         if (line_index != NULL)
-            *line_index = index;
-         return (m_cache_block_info_array[index]);
-      }
+      index -= 4;
+      __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)&m_tags[index]), needle);
+      int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+      if (mask)
+         return index + 31 - __builtin_clz(mask);
    }
-   return NULL;
+#elif defined(__x86_64__) && defined(__SSE2__)
+   const __m128i needle = _mm_set1_epi64x(tag);
+   while (index >= 2)
+   {
+      index -= 2;
+      // SSE2 has no 64-bit compare: both 32-bit halves need to match
+      __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&m_tags[index]), needle);
+      eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+      int mask = _mm_movemask_pd(_mm_castsi128_pd(eq));
+      if (mask)
+         return index + 31 - __builtin_clz(mask);
+   }
+#endif
+
+   while (index > 0)
+   {
+      index--;
+      if (m_tags[index] == tag)
+         return index;
+   }
+   return -1;
+}
+
+CacheBlockInfo*
+CacheSet::find(IntPtr tag, UInt32* line_index)
+{
+   SInt32 index = findWay(tag);
+   if (index < 0)
+      return NULL;
+
+   if (line_index != NULL)
+      *line_index = index;
+   return (m_cache_block_info_array[index]);
 }
 
 bool
 CacheSet::invalidate(IntPtr& tag)
 {
-   for (SInt32 index = m_associativity-1; index >= 0; index--)
-   {
-      if (m_cache_block_info_array[index]->getTag() == tag)
-      {
-         m_cache_block_info_array[index]->invalidate();
-         return true;
-      }
-   }
-   return false;
+   SInt32 index = findWay(tag);
+   if (index < 0)
+      return false;
+
+   m_cache_block_info_array[index]->invalidate();
+   return true;
 }
 
 void
@@ -131,6 +175,26 @@ CacheSet::getDataPtr(UInt32 line_index, UInt32 offset)
    return &m_blocks[line_index * m_blocksize + offset];
 }
 
+void
+CacheSet::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.writeArray(m_tags, m_associativity);
+   writer.writeArray(m_cstates, m_associativity);
+   for (UInt32 i = 0; i < m_associativity; i++)
+      m_cache_block_info_array[i]->saveCheckpoint(writer);
+   saveReplacementState(writer);
+}
+
+bool
+CacheSet::restoreCheckpoint(CheckpointReader &reader)
+{
+   if (!reader.readArray(m_tags, m_associativity) || !reader.readArray(m_cstates, m_associativity))
+      return false;
+   for (UInt32 i = 0; i < m_associativity; i++)
+      m_cache_block_info_array[i]->restoreCheckpoint(reader);
+   return restoreReplacementState(reader);
+}
+
 CacheSet*
 CacheSet::createCacheSet(String cfgname, core_id_t core_id,
       String replacement_policy,
@@ -233,7 +297,7 @@ CacheSet::parsePolicyType(String policy)
 
 bool CacheSet::isValidReplacement(UInt32 index)
 {
-   if (m_cache_block_info_array[index]->getCState() == CacheState::SHARED_UPGRADING)
+   if (m_cstates[index] == CacheState::SHARED_UPGRADING)
    {
       return false;
    }
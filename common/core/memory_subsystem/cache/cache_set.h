@@ -10,6 +10,9 @@
 
 #include <cstring>
 
+class CheckpointWriter;
+class CheckpointReader;
+
 // Per-cache object to store replacement-policy related info (e.g. statistics),
 // can collect data from all CacheSet* objects which are per set and implement the actual replacement policy
 class CacheSetInfo
@@ -30,11 +33,17 @@ class CacheSet
 
    protected:
       CacheBlockInfo** m_cache_block_info_array;
+      // Tags and states of all ways, stored contiguously so lookups do not need to touch the CacheBlockInfo objects.
+      // The CacheBlockInfo objects in m_cache_block_info_array read and write their tag and state from these arrays.
+      IntPtr* m_tags;
+      CacheState::cstate_t* m_cstates;
       char* m_blocks;
       UInt32 m_associativity;
       UInt32 m_blocksize;
       Lock m_lock;
 
+      SInt32 findWay(IntPtr tag) const;
+
    public:
 
       CacheSet(CacheBase::cache_t cache_type,
@@ -60,6 +69,12 @@ class CacheSet
       virtual void updateReplacementIndex(UInt32) = 0;
 
       bool isValidReplacement(UInt32 index);
+
+      // Tags, states, block info and replacement state (but not the data) of all ways
+      void saveCheckpoint(CheckpointWriter &writer);
+      bool restoreCheckpoint(CheckpointReader &reader);
+      virtual void saveReplacementState(CheckpointWriter &writer) {}
+      virtual bool restoreReplacementState(CheckpointReader &reader) { return true; }
 };
 
 #endif /* CACHE_SET_H */
@@ -1,4 +1,5 @@
 #include "cache_set_lru.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 #include "stats.h"
 
@@ -84,6 +85,18 @@ CacheSetLRU::updateReplacementIndex(UInt32 accessed_index)
    moveToMRU(accessed_index);
 }
 
+void
+CacheSetLRU::saveReplacementState(CheckpointWriter &writer)
+{
+   writer.writeArray(m_lru_bits, m_associativity);
+}
+
+bool
+CacheSetLRU::restoreReplacementState(CheckpointReader &reader)
+{
+   return reader.readArray(m_lru_bits, m_associativity);
+}
+
 void
 CacheSetLRU::moveToMRU(UInt32 accessed_index)
 {
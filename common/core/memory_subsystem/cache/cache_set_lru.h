@@ -35,6 +35,8 @@ class CacheSetLRU : public CacheSet
 
       virtual UInt32 getReplacementIndex(CacheCntlr *cntlr);
       void updateReplacementIndex(UInt32 accessed_index);
+      void saveReplacementState(CheckpointWriter &writer);
+      bool restoreReplacementState(CheckpointReader &reader);
 
    protected:
       const UInt8 m_num_attempts;
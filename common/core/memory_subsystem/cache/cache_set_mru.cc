@@ -1,4 +1,5 @@
 #include "cache_set_mru.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 
 // MRU: Most Recently Used
@@ -59,3 +60,15 @@ CacheSetMRU::updateReplacementIndex(UInt32 accessed_index)
    }
    m_lru_bits[accessed_index] = 0;
 }
+
+void
+CacheSetMRU::saveReplacementState(CheckpointWriter &writer)
+{
+   writer.writeArray(m_lru_bits, m_associativity);
+}
+
+bool
+CacheSetMRU::restoreReplacementState(CheckpointReader &reader)
+{
+   return reader.readArray(m_lru_bits, m_associativity);
+}
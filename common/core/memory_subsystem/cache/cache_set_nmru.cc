@@ -1,4 +1,5 @@
 #include "cache_set_nmru.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 
 // NMRU: Not Most Recently Used
@@ -61,3 +62,19 @@ CacheSetNMRU::updateReplacementIndex(UInt32 accessed_index)
    }
    m_lru_bits[accessed_index] = 0;
 }
+
+void
+CacheSetNMRU::saveReplacementState(CheckpointWriter &writer)
+{
+   writer.writeArray(m_lru_bits, m_associativity);
+   writer.write(m_replacement_pointer);
+}
+
+bool
+CacheSetNMRU::restoreReplacementState(CheckpointReader &reader)
+{
+   if (!reader.readArray(m_lru_bits, m_associativity))
+      return false;
+   reader.read(m_replacement_pointer);
+   return true;
+}
@@ -1,4 +1,5 @@
 #include "cache_set_nru.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 
 // NRU: Not Recently Used. Some sort of Pseudo LRU policy.
@@ -83,3 +84,21 @@ CacheSetNRU::updateReplacementIndex(UInt32 accessed_index)
       }
    }
 }
+
+void
+CacheSetNRU::saveReplacementState(CheckpointWriter &writer)
+{
+   writer.writeArray(m_lru_bits, m_associativity);
+   writer.write(m_num_bits_set);
+   writer.write(m_replacement_pointer);
+}
+
+bool
+CacheSetNRU::restoreReplacementState(CheckpointReader &reader)
+{
+   if (!reader.readArray(m_lru_bits, m_associativity))
+      return false;
+   reader.read(m_num_bits_set);
+   reader.read(m_replacement_pointer);
+   return true;
+}
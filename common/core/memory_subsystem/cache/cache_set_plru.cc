@@ -1,4 +1,5 @@
 #include "cache_set_plru.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 
 // Tree LRU for 4 and 8 way caches
@@ -113,3 +114,15 @@ CacheSetPLRU::updateReplacementIndex(UInt32 accessed_index)
       LOG_PRINT_ERROR("PLRU doesn't support associativity %d", m_associativity);
    }
 }
+
+void
+CacheSetPLRU::saveReplacementState(CheckpointWriter &writer)
+{
+   writer.writeArray(b, sizeof(b));
+}
+
+bool
+CacheSetPLRU::restoreReplacementState(CheckpointReader &reader)
+{
+   return reader.readArray(b, sizeof(b));
+}
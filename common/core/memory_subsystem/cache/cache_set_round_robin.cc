@@ -1,4 +1,5 @@
 #include "cache_set_round_robin.h"
+#include "checkpoint_manager.h"
 
 CacheSetRoundRobin::CacheSetRoundRobin(
       CacheBase::cache_t cache_type,
@@ -28,3 +29,16 @@ CacheSetRoundRobin::updateReplacementIndex(UInt32 accessed_index)
 {
    return;
 }
+
+void
+CacheSetRoundRobin::saveReplacementState(CheckpointWriter &writer)
+{
+   writer.write(m_replacement_index);
+}
+
+bool
+CacheSetRoundRobin::restoreReplacementState(CheckpointReader &reader)
+{
+   reader.read(m_replacement_index);
+   return true;
+}
@@ -1,4 +1,5 @@
 #include "cache_set_srrip.h"
+#include "checkpoint_manager.h"
 #include "simulator.h"
 #include "config.hpp"
 #include "log.h"
@@ -103,3 +104,19 @@ CacheSetSRRIP::updateReplacementIndex(UInt32 accessed_index)
    if (m_rrip_bits[accessed_index] > 0)
       m_rrip_bits[accessed_index]--;
 }
+
+void
+CacheSetSRRIP::saveReplacementState(CheckpointWriter &writer)
+{
+   writer.writeArray(m_rrip_bits, m_associativity);
+   writer.write(m_replacement_pointer);
+}
+
+bool
+CacheSetSRRIP::restoreReplacementState(CheckpointReader &reader)
+{
+   if (!reader.readArray(m_rrip_bits, m_associativity))
+      return false;
+   reader.read(m_replacement_pointer);
+   return true;
+}
@@ -1,4 +1,5 @@
 #include "pr_l2_cache_block_info.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 
 MemComponent::component_t 
@@ -60,3 +61,17 @@ PrL2CacheBlockInfo::clone(CacheBlockInfo* cache_block_info)
    m_cached_loc_bitvec = ((PrL2CacheBlockInfo*) cache_block_info)->getCachedLocBitVec();
    CacheBlockInfo::clone(cache_block_info);
 }
+
+void
+PrL2CacheBlockInfo::saveCheckpoint(CheckpointWriter &writer) const
+{
+   writer.write(m_cached_loc_bitvec);
+   CacheBlockInfo::saveCheckpoint(writer);
+}
+
+void
+PrL2CacheBlockInfo::restoreCheckpoint(CheckpointReader &reader)
+{
+   reader.read(m_cached_loc_bitvec);
+   CacheBlockInfo::restoreCheckpoint(reader);
+}
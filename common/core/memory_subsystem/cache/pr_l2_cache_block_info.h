@@ -27,5 +27,7 @@ class PrL2CacheBlockInfo : public CacheBlockInfo
 
       void invalidate();
       void clone(CacheBlockInfo* cache_block_info);
+      void saveCheckpoint(CheckpointWriter &writer) const;
+      void restoreCheckpoint(CheckpointReader &reader);
 };
 #endif /* __PR_L2_CACHE_BLOCK_INFO_H__ */
@@ -4,8 +4,12 @@
 #include "directory_entry_limited_no_broadcast.h"
 #include "directory_entry_limitless.h"
 #include "stats.h"
+#include "checkpoint_manager.h"
 #include "log.h"
 #include "config.hpp"
+
+#include <new>
+#include <algorithm>
 using namespace std;
 
 Directory::Directory(core_id_t core_id, String directory_type_str, UInt32 num_entries, UInt32 max_hw_sharers, UInt32 max_num_sharers):
@@ -14,21 +18,51 @@ Directory::Directory(core_id_t core_id, String directory_type_str, UInt32 num_en
    m_max_hw_sharers(max_hw_sharers),
    m_use_max_hw_sharers(max_hw_sharers), // Value to pass through to DirectoryEntry::addSharer
    m_max_num_sharers(max_num_sharers),
-   m_limitless_software_trap_penalty(SubsecondTime::Zero())
+   m_limitless_software_trap_penalty(SubsecondTime::Zero()),
+   m_inline_entries(false),
+   m_directory_entry_storage(NULL),
+   m_directory_entry_list(NULL)
 {
 cout << "[LINGXI]: /common/core/mem_sub/directory. " << 
 	"num_entries: " << to_string(m_num_entries) << 
 	" max_hw_sharers: " << to_string(m_max_hw_sharers) << 
 	endl;
-   // Look at the type of directory and create
-   m_directory_entry_list = new DirectoryEntry*[m_num_entries];
-
    m_directory_type = parseDirectoryType(directory_type_str);
-   for (UInt32 i = 0; i < m_num_entries; i++)
+   if (m_directory_type == FULL_MAP)
+      m_use_max_hw_sharers = m_max_num_sharers;
+
+   String sharers_type;
+   try
+   {
+      sharers_type = Sim()->getCfg()->getString("perf_model/dram_directory/sharers");
+   }
+   catch(...)
    {
-      m_directory_entry_list[i] = NULL;
+      LOG_PRINT_ERROR("Could not read 'perf_model/dram_directory/sharers' from the config file");
    }
 
+   // Specify the storage class to use for counting the directory sharers.
+   // Due to alignment issues, the minimum size can already hold up to 64 nodes.
+   if (sharers_type == "compact")
+   {
+      setDirectorySharers<DirectorySharersCompact>();
+      m_inline_entries = true;
+   }
+   else if (sharers_type != "bitset")
+   {
+      LOG_PRINT_ERROR("Unsupported directory sharers type: %s", sharers_type.c_str());
+   }
+   else if (m_max_num_sharers <= 64)
+      setDirectorySharers<DirectorySharersBitset<64> >();
+   else if (m_max_num_sharers <= 128)
+      setDirectorySharers<DirectorySharersBitset<128> >();
+   else if (m_max_num_sharers <= 256)
+      setDirectorySharers<DirectorySharersBitset<256> >();
+   else if (m_max_num_sharers <= 1024)
+      setDirectorySharers<DirectorySharersBitset<1024> >();
+   else
+      setDirectorySharers<DirectorySharersVector>();
+
    if (m_directory_type == LIMITLESS)
    {
       try
@@ -41,17 +75,44 @@ cout << "[LINGXI]: /common/core/mem_sub/directory. " <<
       }
    }
 
+   // Entries are created after reading the software trap penalty, which limitless entries copy
+   if (m_inline_entries)
+   {
+      m_directory_entry_storage = new char[(size_t)m_num_entries * m_directory_entry_size];
+      for (UInt32 i = 0; i < m_num_entries; i++)
+         (this->*m_create_directory_entry)(getInlineDirectoryEntry(i));
+      m_num_entries_allocated = m_num_entries;
+   }
+   else
+   {
+      m_directory_entry_list = new DirectoryEntry*[m_num_entries];
+      for (UInt32 i = 0; i < m_num_entries; i++)
+      {
+         m_directory_entry_list[i] = NULL;
+      }
+   }
+
    registerStatsMetric("directory", core_id, "entries-allocated", &m_num_entries_allocated);
+   Sim()->getStatsManager()->registerMetric(new StatsMetricCallback("directory", core_id, "memory-bytes", getMemoryUsageCallback, (UInt64)this));
 }
 
 Directory::~Directory()
 {
-   for (UInt32 i = 0; i < m_num_entries; i++)
+   if (m_inline_entries)
+   {
+      for (UInt32 i = 0; i < m_num_entries; i++)
+         getInlineDirectoryEntry(i)->~DirectoryEntry();
+      delete [] m_directory_entry_storage;
+   }
+   else
    {
-      if (m_directory_entry_list[i])
-         delete m_directory_entry_list[i];
+      for (UInt32 i = 0; i < m_num_entries; i++)
+      {
+         if (m_directory_entry_list[i])
+            delete m_directory_entry_list[i];
+      }
+      delete [] m_directory_entry_list;
    }
-   delete [] m_directory_entry_list;
 }
 
 DirectoryEntry*
@@ -59,6 +120,9 @@ Directory::getDirectoryEntry(UInt32 entry_num)
 {
    LOG_ASSERT_ERROR(entry_num < m_num_entries, "Invalid entry_num(%d) >= num_entries(%d)", entry_num, m_num_entries);
 
+   if (m_inline_entries)
+      return getInlineDirectoryEntry(entry_num);
+
    if (m_directory_entry_list[entry_num] == NULL)
    {
       m_directory_entry_list[entry_num] = createDirectoryEntry();
@@ -67,10 +131,130 @@ Directory::getDirectoryEntry(UInt32 entry_num)
    return m_directory_entry_list[entry_num];
 }
 
+DirectoryEntry*
+Directory::replaceDirectoryEntry(UInt32 entry_num)
+{
+   LOG_ASSERT_ERROR(entry_num < m_num_entries, "Invalid entry_num(%d) >= num_entries(%d)", entry_num, m_num_entries);
+
+   DirectoryEntry* replaced_directory_entry;
+   if (m_inline_entries)
+   {
+      // Inline entries cannot be handed out, move the old state to the heap and reset the slot
+      DirectoryEntry* directory_entry = getInlineDirectoryEntry(entry_num);
+      replaced_directory_entry = directory_entry->clone();
+      directory_entry->~DirectoryEntry();
+      (this->*m_create_directory_entry)(directory_entry);
+   }
+   else
+   {
+      replaced_directory_entry = getDirectoryEntry(entry_num);
+      m_directory_entry_list[entry_num] = createDirectoryEntry();
+   }
+   return replaced_directory_entry;
+}
+
 void
-Directory::setDirectoryEntry(UInt32 entry_num, DirectoryEntry* directory_entry)
+Directory::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.write(m_num_entries);
+   writer.write(UInt32(m_directory_type));
+   for (UInt32 i = 0; i < m_num_entries; i++)
+   {
+      DirectoryEntry* directory_entry = m_inline_entries ? getInlineDirectoryEntry(i) : m_directory_entry_list[i];
+      if (!directory_entry || directory_entry->getAddress() == INVALID_ADDRESS)
+         continue;
+
+      std::vector<core_id_t> sharers = directory_entry->getSharersList().second;
+      writer.write(i);
+      writer.write(directory_entry->getAddress());
+      writer.write(UInt32(directory_entry->getDirectoryBlockInfo()->getDState()));
+      writer.write(directory_entry->getOwner());
+      writer.writeArray(sharers);
+   }
+   writer.write(m_num_entries); // End marker
+}
+
+bool
+Directory::restoreCheckpoint(CheckpointReader &reader)
+{
+   if (reader.read<UInt32>() != m_num_entries || reader.read<UInt32>() != UInt32(m_directory_type))
+      return false;
+
+   // Read and validate all entries before touching the directory, so a mismatching checkpoint leaves it unchanged
+   struct SavedEntry
+   {
+      UInt32 entry_num;
+      IntPtr address;
+      UInt32 dstate;
+      core_id_t owner;
+      std::vector<core_id_t> sharers;
+   };
+   std::vector<SavedEntry> entries;
+   while (true)
+   {
+      SavedEntry entry;
+      entry.entry_num = reader.read<UInt32>();
+      if (entry.entry_num == m_num_entries)
+         break;
+      if (entry.entry_num > m_num_entries)
+         return false;
+      entry.address = reader.read<IntPtr>();
+      entry.dstate = reader.read<UInt32>();
+      entry.owner = reader.read<core_id_t>();
+      entry.sharers.resize(reader.read<UInt64>());
+      reader.read(entry.sharers.data(), entry.sharers.size() * sizeof(core_id_t));
+
+      // Only limitless entries accept more than max_hw_sharers sharers
+      if (entry.dstate >= DirectoryState::NUM_DIRECTORY_STATES
+         || (m_directory_type != LIMITLESS && entry.sharers.size() > m_use_max_hw_sharers))
+         return false;
+      std::sort(entry.sharers.begin(), entry.sharers.end());
+      if (std::adjacent_find(entry.sharers.begin(), entry.sharers.end()) != entry.sharers.end()
+         || (!entry.sharers.empty() && (entry.sharers.front() < 0 || UInt32(entry.sharers.back()) >= m_max_num_sharers))
+         || (entry.owner != INVALID_CORE_ID && !std::binary_search(entry.sharers.begin(), entry.sharers.end(), entry.owner)))
+         return false;
+
+      entries.push_back(entry);
+   }
+
+   for (std::vector<SavedEntry>::iterator it = entries.begin(); it != entries.end(); ++it)
+   {
+      // Start from a fresh entry, in case this one was already in use
+      delete replaceDirectoryEntry(it->entry_num);
+      DirectoryEntry* directory_entry = getDirectoryEntry(it->entry_num);
+      directory_entry->setAddress(it->address);
+      directory_entry->getDirectoryBlockInfo()->setDState(DirectoryState::dstate_t(it->dstate));
+      for (std::vector<core_id_t>::iterator sharer = it->sharers.begin(); sharer != it->sharers.end(); ++sharer)
+      {
+         bool added = directory_entry->addSharer(*sharer, m_use_max_hw_sharers);
+         LOG_ASSERT_ERROR(added, "Could not restore sharer %d of directory entry %u", *sharer, it->entry_num);
+      }
+      // The owner must already be a sharer
+      directory_entry->setOwner(it->owner);
+   }
+   return true;
+}
+
+UInt64
+Directory::getMemoryUsage()
+{
+   UInt64 memory_usage = 0;
+   if (!m_inline_entries)
+      memory_usage += m_num_entries * sizeof(DirectoryEntry*);
+
+   for (UInt32 i = 0; i < m_num_entries; i++)
+   {
+      DirectoryEntry* directory_entry = m_inline_entries ? getInlineDirectoryEntry(i) : m_directory_entry_list[i];
+      if (directory_entry)
+         memory_usage += m_directory_entry_size + directory_entry->getSharersHeapSize();
+   }
+   return memory_usage;
+}
+
+UInt64
+Directory::getMemoryUsageCallback(String objectName, UInt32 index, String metricName, UInt64 arg)
 {
-   m_directory_entry_list[entry_num] = directory_entry;
+   return ((Directory*)arg)->getMemoryUsage();
 }
 
 Directory::DirectoryType
@@ -89,37 +273,48 @@ Directory::parseDirectoryType(String directory_type_str)
    }
 }
 
-DirectoryEntry*
-Directory::createDirectoryEntry()
+template <class DirectorySharers>
+void
+Directory::setDirectorySharers()
 {
-   // Specify the storage class to use for counting the directory sharers.
-   // Due to alignment issues, the minimum size can already hold up to 64 nodes.
-   if (m_max_num_sharers <= 64)
-      return createDirectoryEntrySized<DirectorySharersBitset<64> >();
-   else if (m_max_num_sharers <= 128)
-      return createDirectoryEntrySized<DirectorySharersBitset<128> >();
-   else if (m_max_num_sharers <= 256)
-      return createDirectoryEntrySized<DirectorySharersBitset<256> >();
-   else if (m_max_num_sharers <= 1024)
-      return createDirectoryEntrySized<DirectorySharersBitset<1024> >();
-   else
-      return createDirectoryEntrySized<DirectorySharersVector>();
+   m_create_directory_entry = &Directory::createDirectoryEntrySized<DirectorySharers>;
+
+   switch (m_directory_type)
+   {
+      case FULL_MAP:
+      case LIMITED_NO_BROADCAST:
+         m_directory_entry_size = sizeof(DirectoryEntryLimitedNoBroadcast<DirectorySharers>);
+         break;
+
+      case LIMITLESS:
+         m_directory_entry_size = sizeof(DirectoryEntryLimitless<DirectorySharers>);
+         break;
+
+      default:
+         LOG_PRINT_ERROR("Unrecognized Directory Type: %u", m_directory_type);
+   }
 }
 
 template <class DirectorySharers>
 DirectoryEntry*
-Directory::createDirectoryEntrySized()
+Directory::createDirectoryEntrySized(void *place)
 {
+   // Construct at place when given (inline entries), else on the heap
    switch (m_directory_type)
    {
       case FULL_MAP:
-         m_use_max_hw_sharers = m_max_num_sharers;
+         if (place)
+            return new (place) DirectoryEntryLimitedNoBroadcast<DirectorySharers>(m_max_num_sharers, m_max_num_sharers);
          return new DirectoryEntryLimitedNoBroadcast<DirectorySharers>(m_max_num_sharers, m_max_num_sharers);
 
       case LIMITED_NO_BROADCAST:
+         if (place)
+            return new (place) DirectoryEntryLimitedNoBroadcast<DirectorySharers>(m_max_hw_sharers, m_max_num_sharers);
          return new DirectoryEntryLimitedNoBroadcast<DirectorySharers>(m_max_hw_sharers, m_max_num_sharers);
 
       case LIMITLESS:
+         if (place)
+            return new (place) DirectoryEntryLimitless<DirectorySharers>(m_max_hw_sharers, m_max_num_sharers, m_limitless_software_trap_penalty);
          return new DirectoryEntryLimitless<DirectorySharers>(m_max_hw_sharers, m_max_num_sharers, m_limitless_software_trap_penalty);
 
       default:
@@ -5,6 +5,9 @@
 #include "fixed_types.h"
 #include "subsecond_time.h"
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class Directory
 {
    public:
@@ -27,19 +30,39 @@ class Directory
       // FIXME: Hack: Get me out of here
       SubsecondTime m_limitless_software_trap_penalty;
 
+      // Sharer set storage type, selected once at construction
+      DirectoryEntry* (Directory::*m_create_directory_entry)(void *place);
+      UInt32 m_directory_entry_size;
+
+      // With compact sharers, all entries are constructed up front in one contiguous array (m_directory_entry_storage,
+      // entries of a set are adjacent) rather than allocated one by one on the heap (m_directory_entry_list)
+      bool m_inline_entries;
+      char* m_directory_entry_storage;
       DirectoryEntry** m_directory_entry_list;
 
+      template <class DirectorySharers> void setDirectorySharers();
+      template <class DirectorySharers> DirectoryEntry* createDirectoryEntrySized(void *place);
+      DirectoryEntry* getInlineDirectoryEntry(UInt32 entry_num)
+      { return (DirectoryEntry*)(m_directory_entry_storage + entry_num * m_directory_entry_size); }
+
+      static UInt64 getMemoryUsageCallback(String objectName, UInt32 index, String metricName, UInt64 arg);
+
    public:
       Directory(core_id_t core_id, String directory_type_str, UInt32 num_entries, UInt32 max_hw_sharers, UInt32 max_num_sharers);
       ~Directory();
 
       DirectoryEntry* getDirectoryEntry(UInt32 entry_num);
-      void setDirectoryEntry(UInt32 entry_num, DirectoryEntry* directory_entry);
-      DirectoryEntry* createDirectoryEntry();
-      template <class DirectorySharers> DirectoryEntry* createDirectoryEntrySized();
+      // Take the entry out of the directory and put a fresh one in its place. The caller owns the returned entry.
+      DirectoryEntry* replaceDirectoryEntry(UInt32 entry_num);
+      DirectoryEntry* createDirectoryEntry() { return (this->*m_create_directory_entry)(NULL); }
+      UInt64 getMemoryUsage();
 
       UInt32 getMaxHwSharers() const { return m_use_max_hw_sharers; }
 
+      // Address, state, owner and sharers of all valid entries
+      void saveCheckpoint(CheckpointWriter &writer);
+      bool restoreCheckpoint(CheckpointReader &reader);
+
       static DirectoryType parseDirectoryType(String directory_type_str);
 };
 
@@ -7,30 +7,179 @@
 
 #include <vector>
 #include <bitset>
+#include <algorithm>
 #include <cassert>
 
+// Sharer sets: each storage class provides size(), count(), test(), set(), reset(),
+// getSharers() (in ascending core id order) and getHeapSize() (memory used outside the entry itself)
+
+inline void directorySharersFromBits(const UInt64 *bits, UInt32 num_words, std::vector<core_id_t> &sharers)
+{
+   for(UInt32 w = 0; w < num_words; ++w)
+      for(UInt64 word = bits[w]; word; word &= word - 1)
+         sharers.push_back(w * 64 + __builtin_ctzll(word));
+}
+
 template <long Size>
 class DirectorySharersBitset : public std::bitset<Size>
 {
    public:
       DirectorySharersBitset(UInt32 max_num_sharers) : std::bitset<Size>()
       { assert(max_num_sharers <= Size); }
+      void getSharers(std::vector<core_id_t> &sharers) const
+      {
+         for(UInt32 j = 0; j < Size; ++j)
+            if (this->test(j))
+               sharers.push_back(j);
+      }
+      UInt64 getHeapSize() const { return 0; }
 };
 
-class DirectorySharersVector : public std::vector<bool>
+class DirectorySharersVector
 {
+   private:
+      std::vector<UInt64> m_bits;
+      UInt32 m_size;
+
    public:
-      DirectorySharersVector(UInt32 max_num_sharers) : std::vector<bool>(max_num_sharers, false) {}
-      UInt32 count(void) const
+      DirectorySharersVector(UInt32 max_num_sharers) : m_bits((max_num_sharers + 63) / 64, 0), m_size(max_num_sharers) {}
+      UInt32 size() const { return m_size; }
+      UInt32 count() const
       {
          UInt32 num_sharers = 0;
-         for(UInt32 j = 0; j < this->size(); ++j) {
-            if ((*this)[j]) {
-               num_sharers ++;
+         for(UInt32 w = 0; w < m_bits.size(); ++w)
+            num_sharers += __builtin_popcountll(m_bits[w]);
+         return num_sharers;
+      }
+      bool test(UInt32 sharer) const { return m_bits[sharer / 64] & (1ULL << (sharer % 64)); }
+      void set(UInt32 sharer) { m_bits[sharer / 64] |= 1ULL << (sharer % 64); }
+      void reset(UInt32 sharer) { m_bits[sharer / 64] &= ~(1ULL << (sharer % 64)); }
+      void getSharers(std::vector<core_id_t> &sharers) const { directorySharersFromBits(&m_bits[0], m_bits.size(), sharers); }
+      UInt64 getHeapSize() const { return m_bits.capacity() * sizeof(UInt64); }
+};
+
+// Most lines have only a few sharers, even with hundreds of cores. Keep up to NUM_INLINE sharers
+// as a sorted list inside the entry, and only allocate a bitset once more cores share the line.
+// The bitset is freed again when the last sharer is removed.
+class DirectorySharersCompact
+{
+   private:
+      static const UInt32 NUM_INLINE = 4;
+
+      UInt16 m_size;
+      UInt16 m_count;
+      bool m_promoted;
+      union
+      {
+         UInt16 m_list[NUM_INLINE];
+         UInt64 *m_bits;
+      };
+
+      UInt32 getNumWords() const { return (m_size + 63) / 64; }
+
+      void promote()
+      {
+         UInt64 *bits = new UInt64[getNumWords()]();
+         for(UInt32 i = 0; i < m_count; ++i)
+            bits[m_list[i] / 64] |= 1ULL << (m_list[i] % 64);
+         m_bits = bits;
+         m_promoted = true;
+      }
+
+   public:
+      DirectorySharersCompact(UInt32 max_num_sharers)
+         : m_size(max_num_sharers)
+         , m_count(0)
+         , m_promoted(false)
+      { assert(max_num_sharers <= 0xffff); }
+      DirectorySharersCompact(const DirectorySharersCompact &orig)
+         : m_size(orig.m_size)
+         , m_count(orig.m_count)
+         , m_promoted(orig.m_promoted)
+      {
+         if (m_promoted)
+         {
+            m_bits = new UInt64[getNumWords()];
+            std::copy(orig.m_bits, orig.m_bits + getNumWords(), m_bits);
+         }
+         else
+            std::copy(orig.m_list, orig.m_list + NUM_INLINE, m_list);
+      }
+      ~DirectorySharersCompact()
+      {
+         if (m_promoted)
+            delete [] m_bits;
+      }
+
+      UInt32 size() const { return m_size; }
+      UInt32 count() const { return m_count; }
+
+      bool test(UInt32 sharer) const
+      {
+         if (m_promoted)
+            return m_bits[sharer / 64] & (1ULL << (sharer % 64));
+         for(UInt32 i = 0; i < m_count; ++i)
+            if (m_list[i] == sharer)
+               return true;
+         return false;
+      }
+
+      void set(UInt32 sharer)
+      {
+         if (test(sharer))
+            return;
+         if (!m_promoted && m_count == NUM_INLINE)
+            promote();
+
+         if (m_promoted)
+            m_bits[sharer / 64] |= 1ULL << (sharer % 64);
+         else
+         {
+            UInt32 i = m_count;
+            for(; i > 0 && m_list[i - 1] > sharer; --i)
+               m_list[i] = m_list[i - 1];
+            m_list[i] = sharer;
+         }
+         ++m_count;
+      }
+
+      void reset(UInt32 sharer)
+      {
+         if (!test(sharer))
+            return;
+         --m_count;
+
+         if (m_promoted)
+         {
+            m_bits[sharer / 64] &= ~(1ULL << (sharer % 64));
+            if (m_count == 0)
+            {
+               delete [] m_bits;
+               m_promoted = false;
             }
          }
-         return num_sharers;
+         else
+         {
+            UInt32 i = 0;
+            while(m_list[i] != sharer)
+               ++i;
+            for(; i < m_count; ++i)
+               m_list[i] = m_list[i + 1];
+         }
+      }
+
+      void getSharers(std::vector<core_id_t> &sharers) const
+      {
+         if (m_promoted)
+            directorySharersFromBits(m_bits, getNumWords(), sharers);
+         else
+            sharers.insert(sharers.end(), m_list, m_list + m_count);
       }
+
+      UInt64 getHeapSize() const { return m_promoted ? getNumWords() * sizeof(UInt64) : 0; }
+
+   private:
+      DirectorySharersCompact& operator=(const DirectorySharersCompact &); // Not implemented
 };
 
 class DirectoryEntry
@@ -77,6 +226,11 @@ class DirectoryEntry
       virtual std::pair<bool, std::vector<core_id_t> > getSharersList() = 0;
 
       virtual SubsecondTime getLatency() = 0;
+
+      // Copy of this entry on the heap, used when an entry stored inline in the Directory is replaced
+      virtual DirectoryEntry* clone() = 0;
+      // Memory used by the sharer set outside of the entry itself
+      virtual UInt64 getSharersHeapSize() = 0;
 };
 
 template <class DirectorySharers>
@@ -97,20 +251,12 @@ class DirectoryEntrySized : public DirectoryEntry
       {
          std::pair<bool, std::vector<core_id_t> > sharers_list;
          sharers_list.first = false;
-         sharers_list.second.resize(getNumSharers());
-
-         SInt32 i = 0;
-         for(UInt32 j = 0; j < m_sharers.size(); ++j) {
-            if (m_sharers[j]) {
-               core_id_t new_sharer = j;
-               sharers_list.second[i] = new_sharer;
-               i++;
-               assert (i <= (core_id_t) m_sharers.size());
-            }
-         }
+         sharers_list.second.reserve(getNumSharers());
+         m_sharers.getSharers(sharers_list.second);
 
          return sharers_list;
       }
+      virtual UInt64 getSharersHeapSize() { return m_sharers.getHeapSize(); }
 };
 
 #endif /* __DIRECTORY_ENTRY_H__ */
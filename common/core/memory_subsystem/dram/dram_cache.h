@@ -5,6 +5,7 @@
 #include "subsecond_time.h"
 #include "cache.h"
 #include "contention_model.h"
+#include "lock.h"
 
 class QueueModel;
 class Prefetcher;
@@ -38,6 +39,9 @@ class DramCache : public DramCntlrInterface
       UInt64 m_hits_prefetch, m_prefetches;
       SubsecondTime m_prefetch_mshr_delay;
 
+      // In vault-local mode, the local LLC calls us directly while the directory does so for all other cores
+      Lock m_lock;
+
       std::pair<bool, SubsecondTime> doAccess(Cache::access_t access, IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now, ShmemPerf *perf);
       void insertLine(Cache::access_t access, IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now);
       SubsecondTime accessDataArray(Cache::access_t access, core_id_t requester, SubsecondTime t_start, ShmemPerf *perf);
@@ -0,0 +1,216 @@
+#include "dram_trace.h"
+#include "simulator.h"
+#include "config.h"
+#include "config.hpp"
+#include "hooks_manager.h"
+#include "magic_server.h"
+#include "hmc_address_map.h"
+#include "stats.h"
+#include "tls.h"
+#include "log.h"
+
+#include <cstring>
+
+static_assert(sizeof(DramTraceHeader) == 40, "DramTraceHeader must not contain padding");
+static_assert(sizeof(DramTraceRecord) == 48, "DramTraceRecord must not contain padding");
+
+static UInt32 toPS(SubsecondTime time)
+{
+   UInt64 ps = time.getPS();
+   return ps > UINT32_MAX ? UINT32_MAX : ps;
+}
+
+DramTrace*
+DramTrace::getSingleton()
+{
+   // Thread-safe construction on first use (C++11 magic statics), after the configuration has been loaded
+   static DramTrace *s_dram_trace = Sim()->getCfg()->getBool("perf_model/dram/trace/enabled") ? new DramTrace() : NULL;
+   return s_dram_trace;
+}
+
+DramTrace::DramTrace()
+   : m_buffer_size(Sim()->getCfg()->getInt("perf_model/dram/trace/buffer_size"))
+   , m_compression_level(Sim()->getCfg()->getInt("perf_model/dram/trace/compression_level"))
+   , m_hmc_map(HmcAddressMap::getSingleton())
+   , m_active(Sim()->getMagicServer()->inROI())
+   , m_thread_buffer(TLS::create())
+   , m_running(true)
+   , m_stop(false)
+   , m_num_records(0)
+   , m_num_chunks(0)
+{
+   LOG_ASSERT_ERROR(m_buffer_size > 0, "perf_model/dram/trace/buffer_size must be at least 1");
+   LOG_ASSERT_ERROR(m_compression_level >= 0 && m_compression_level <= 9,
+      "perf_model/dram/trace/compression_level must be between 0 and 9, not %d", m_compression_level);
+
+   registerStatsMetric("dram-trace", 0, "records", &m_num_records);
+   registerStatsMetric("dram-trace", 0, "chunks", &m_num_chunks);
+
+   Sim()->getHooksManager()->registerHook(HookType::HOOK_ROI_BEGIN, hookRoiBegin, (UInt64)this);
+   Sim()->getHooksManager()->registerHook(HookType::HOOK_ROI_END, hookRoiEnd, (UInt64)this);
+   Sim()->getHooksManager()->registerHook(HookType::HOOK_SIM_END, hookSimEnd, (UInt64)this);
+
+   m_thread = _Thread::create(this);
+   m_thread->run();
+}
+
+void
+DramTrace::addRecord(UInt32 controller, core_id_t requester, SubsecondTime time, IntPtr address,
+   DramCntlrInterface::access_t type, SubsecondTime latency,
+   SubsecondTime queue, SubsecondTime bus, SubsecondTime device)
+{
+   DramTraceRecord record;
+   record.time = time.getFS();
+   record.address = address;
+   record.requester = requester;
+   record.latency = toPS(latency);
+   record.queue = toPS(queue);
+   record.bus = toPS(bus);
+   record.device = toPS(device);
+   record.controller = controller;
+   record.vault = m_hmc_map->getGlobalVault(address);
+   record.bank = m_hmc_map->getBank(address);
+   record.type = type;
+   memset(record.reserved, 0, sizeof(record.reserved));
+
+   ThreadBuffer *buffer = getThreadBuffer();
+   ScopedLock sl(buffer->lock);
+   buffer->records.push_back(record);
+   if (buffer->records.size() >= m_buffer_size)
+      enqueue(buffer->records);
+}
+
+DramTrace::ThreadBuffer*
+DramTrace::getThreadBuffer()
+{
+   ThreadBuffer *buffer = m_thread_buffer->getPtr<ThreadBuffer>();
+   if (!buffer)
+   {
+      buffer = new ThreadBuffer();
+      buffer->records.reserve(m_buffer_size);
+      m_thread_buffer->set(buffer);
+
+      ScopedLock sl(m_thread_buffers_lock);
+      m_thread_buffers.push_back(buffer);
+   }
+   return buffer;
+}
+
+void
+DramTrace::enqueue(Chunk &records)
+{
+   Chunk *chunk = new Chunk();
+   chunk->swap(records);
+   records.reserve(m_buffer_size);
+
+   ScopedLock sl(m_queue_lock);
+   // Stall the simulation rather than buffering without bound when compression cannot keep up
+   while (m_queue.size() >= MAX_QUEUED_CHUNKS)
+      m_queue_done_cond.wait(m_queue_lock);
+   m_queue.push_back(chunk);
+   m_queue_cond.signal();
+}
+
+void
+DramTrace::finish()
+{
+   m_active = false;
+
+   {
+      ScopedLock sl(m_thread_buffers_lock);
+      for(std::vector<ThreadBuffer*>::iterator it = m_thread_buffers.begin(); it != m_thread_buffers.end(); ++it)
+      {
+         ScopedLock sl_buffer((*it)->lock);
+         if ((*it)->records.size())
+            enqueue((*it)->records);
+      }
+   }
+
+   // Let the writer thread drain the queue and exit
+   {
+      ScopedLock sl(m_queue_lock);
+      m_stop = true;
+      m_queue_cond.signal();
+      while (m_running)
+         m_queue_done_cond.wait(m_queue_lock);
+   }
+
+   for(std::vector<gzFile>::iterator it = m_files.begin(); it != m_files.end(); ++it)
+      if (*it)
+         gzclose(*it);
+   m_files.clear();
+}
+
+void
+DramTrace::run()
+{
+   ScopedLock sl(m_queue_lock);
+   while (true)
+   {
+      while (m_queue.empty() && !m_stop)
+         m_queue_cond.wait(m_queue_lock);
+      if (m_queue.empty())
+         break;
+
+      // Compress without holding the queue lock, so the simulation can keep queueing chunks
+      Chunk *chunk = m_queue.front();
+      m_queue_lock.release();
+      writeChunk(chunk);
+      delete chunk;
+      m_queue_lock.acquire();
+
+      m_queue.pop_front();
+      m_queue_done_cond.broadcast();
+   }
+   m_running = false;
+   m_queue_done_cond.broadcast();
+}
+
+void
+DramTrace::writeChunk(Chunk *chunk)
+{
+   // A thread's buffer holds records for any controller, split them up by output file
+   for(Chunk::iterator it = chunk->begin(); it != chunk->end(); ++it)
+   {
+      if (it->controller >= m_staging.size())
+         m_staging.resize(it->controller + 1);
+      m_staging[it->controller].push_back(*it);
+   }
+
+   for(UInt32 controller = 0; controller < m_staging.size(); ++controller)
+   {
+      Chunk &records = m_staging[controller];
+      if (records.empty())
+         continue;
+      gzFile file = getFile(controller);
+      if (gzwrite(file, records.data(), records.size() * sizeof(DramTraceRecord)) == 0)
+         LOG_PRINT_WARNING_ONCE("Error writing DRAM trace for controller %u", controller);
+      records.clear();
+   }
+
+   m_num_records += chunk->size();
+   ++m_num_chunks;
+}
+
+gzFile
+DramTrace::getFile(UInt32 controller)
+{
+   if (controller >= m_files.size())
+      m_files.resize(controller + 1, NULL);
+
+   if (!m_files[controller])
+   {
+      String filename = Sim()->getConfig()->formatOutputFileName("dram-trace-" + itostr(controller) + ".bin.gz");
+      gzFile file = gzopen(filename.c_str(), ("wb" + itostr(m_compression_level)).c_str());
+      LOG_ASSERT_ERROR(file != NULL, "Cannot open DRAM trace file %s", filename.c_str());
+      gzbuffer(file, 1 << 20);
+
+      DramTraceHeader header = { MAGIC, VERSION, sizeof(DramTraceRecord), controller,
+         m_hmc_map->getNumCubes(), m_hmc_map->getVaultsPerCube(), m_hmc_map->getBanksPerVault(), m_hmc_map->getMapping(),
+         m_hmc_map->getBlockSize(), m_hmc_map->getPageSize() };
+      gzwrite(file, &header, sizeof(header));
+
+      m_files[controller] = file;
+   }
+   return m_files[controller];
+}
@@ -0,0 +1,127 @@
+#ifndef __DRAM_TRACE_H
+#define __DRAM_TRACE_H
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "dram_cntlr_interface.h"
+#include "lock.h"
+#include "cond.h"
+#include "_thread.h"
+
+#include <deque>
+#include <vector>
+#include <zlib.h>
+
+class TLS;
+class HmcAddressMap;
+
+// Binary trace of all DRAM accesses, enabled through perf_model/dram/trace/enabled.
+//
+// Each simulator thread appends fixed-size records to its own buffer, full buffers are handed to a
+// background thread which compresses them into one file per DRAM controller
+// (dram-trace-<controller>.bin.gz in the output directory). Only accesses inside the ROI are recorded.
+// Use tools/dramtrace.py to read the traces back.
+//
+// File layout: a DramTraceHeader followed by DramTraceRecords, all little-endian.
+
+struct DramTraceHeader
+{
+   UInt32 magic;
+   UInt32 version;
+   UInt32 record_size;
+   UInt32 controller;
+   UInt32 num_cubes;          // HMC geometry used to compute the vault and bank fields
+   UInt32 vaults_per_cube;
+   UInt32 banks_per_vault;
+   UInt32 mapping;            // HmcAddressMap::mapping_t
+   UInt32 block_size;
+   UInt32 page_size;
+};
+
+struct DramTraceRecord
+{
+   UInt64 time;               // Time the request arrived at the controller, in fs
+   UInt64 address;
+   SInt32 requester;
+   UInt32 latency;            // Total access latency, in ps
+   UInt32 queue;              // Latency breakdown (ShmemPerf DRAM_QUEUE, DRAM_BUS, DRAM_DEVICE), in ps
+   UInt32 bus;
+   UInt32 device;
+   UInt16 controller;
+   UInt16 vault;              // Global vault (cube * vaults_per_cube + vault)
+   UInt16 bank;
+   UInt8 type;                // DramCntlrInterface::access_t
+   UInt8 reserved[5];
+};
+
+class DramTrace : public Runnable
+{
+   public:
+      static const UInt32 MAGIC = 0x31544453; // "SDT1"
+      static const UInt32 VERSION = 2;
+
+      // Returns NULL when tracing is disabled
+      static DramTrace* getSingleton();
+
+      void record(UInt32 controller, core_id_t requester, SubsecondTime time, IntPtr address,
+         DramCntlrInterface::access_t type, SubsecondTime latency,
+         SubsecondTime queue, SubsecondTime bus, SubsecondTime device)
+      {
+         if (m_active)
+            addRecord(controller, requester, time, address, type, latency, queue, bus, device);
+      }
+
+   private:
+      typedef std::vector<DramTraceRecord> Chunk;
+
+      struct ThreadBuffer
+      {
+         Lock lock;           // Only contended when flushing at the end of simulation
+         Chunk records;
+      };
+
+      const UInt32 m_buffer_size;
+      const int m_compression_level;
+      const HmcAddressMap *m_hmc_map;
+      volatile bool m_active;
+
+      TLS *m_thread_buffer;
+      std::vector<ThreadBuffer*> m_thread_buffers;
+      Lock m_thread_buffers_lock;
+
+      // Full buffers waiting to be written, consumed by the writer thread
+      static const UInt32 MAX_QUEUED_CHUNKS = 64;
+      std::deque<Chunk*> m_queue;
+      bool m_running;
+      bool m_stop;
+      _Thread *m_thread;
+      Lock m_queue_lock;
+      ConditionVariable m_queue_cond;        // Signaled when a chunk is queued, or the thread should stop
+      ConditionVariable m_queue_done_cond;   // Signaled when a chunk was written, or the thread stopped
+
+      // Owned by the writer thread, files are opened on the first record for each controller
+      std::vector<gzFile> m_files;
+      std::vector<Chunk> m_staging;
+
+      UInt64 m_num_records;
+      UInt64 m_num_chunks;
+
+      DramTrace();
+
+      void addRecord(UInt32 controller, core_id_t requester, SubsecondTime time, IntPtr address,
+         DramCntlrInterface::access_t type, SubsecondTime latency,
+         SubsecondTime queue, SubsecondTime bus, SubsecondTime device);
+      ThreadBuffer* getThreadBuffer();
+      void enqueue(Chunk &records);
+      void writeChunk(Chunk *chunk);
+      gzFile getFile(UInt32 controller);
+      void finish();
+
+      void run();
+
+      static SInt64 hookRoiBegin(UInt64 self, UInt64) { ((DramTrace*)self)->m_active = true; return 0; }
+      static SInt64 hookRoiEnd(UInt64 self, UInt64) { ((DramTrace*)self)->m_active = false; return 0; }
+      static SInt64 hookSimEnd(UInt64 self, UInt64) { ((DramTrace*)self)->finish(); return 0; }
+};
+
+#endif // __DRAM_TRACE_H
@@ -181,7 +181,14 @@ cout << "%%%%%%%%%%%%%%%% cache controller for core_id: " << to_string(m_core_id
             Sim()->getFaultinjectionManager()
                ? Sim()->getFaultinjectionManager()->getFaultInjector(m_core_id_master, mem_component)
                : NULL);
-      m_master->m_prefetcher = Prefetcher::createPrefetcher(cache_params.prefetcher, cache_params.configName, m_core_id, m_shared_cores);
+      m_master->m_prefetcher = Prefetcher::createPrefetcher(cache_params.prefetcher, cache_params.configName, m_core_id, m_shared_cores, m_cache_block_size);
+      if (m_master->m_prefetcher)
+      {
+         m_master->m_prefetch_queue_length = Sim()->getCfg()->getIntArray("perf_model/" + cache_params.configName + "/prefetcher/queue_length", core_id);
+         m_master->m_prefetch_issue_width = Sim()->getCfg()->getIntArray("perf_model/" + cache_params.configName + "/prefetcher/issue_width", core_id);
+         m_master->m_prefetch_interval = SubsecondTime::PS() * (UInt64)(1000 * Sim()->getCfg()->getFloatArray("perf_model/" + cache_params.configName + "/prefetcher/issue_interval", core_id));
+         m_master->m_prefetch_buffer.resize(m_master->m_prefetch_queue_length);
+      }
 
       if (Sim()->getCfg()->getBoolDefault("perf_model/" + cache_params.configName + "/atd/enabled", false))
       {
@@ -249,6 +256,7 @@ cout << "%%%%%%%%%%%%%%%% cache controller for core_id: " << to_string(m_core_id
    registerStatsMetric(name, core_id, "coherency-upgrades", &stats.coherency_upgrades);
    registerStatsMetric(name, core_id, "coherency-writebacks", &stats.coherency_writebacks);
    registerStatsMetric(name, core_id, "coherency-invalidates", &stats.coherency_invalidates);
+   registerStatsMetric(name, core_id, "vault-local-writebacks", &stats.vault_local_writebacks);
 #ifdef ENABLE_TRANSITIONS
    for(CacheState::cstate_t old_state = CacheState::CSTATE_FIRST; old_state < CacheState::NUM_CSTATE_STATES; old_state = CacheState::cstate_t(int(old_state)+1))
       for(CacheState::cstate_t new_state = CacheState::CSTATE_FIRST; new_state < CacheState::NUM_CSTATE_STATES; new_state = CacheState::cstate_t(int(new_state)+1))
@@ -310,6 +318,15 @@ CacheCntlr::setDRAMDirectAccess(DramCntlrInterface* dram_cntlr, UInt64 num_outst
    m_master->m_dram_outstanding_writebacks = new ContentionModel("llc-evict-queue", m_core_id, num_outstanding);
 }
 
+void
+CacheCntlr::setDRAMVaultLocalAccess(DramCntlrInterface* dram_cntlr, AddressHomeLookup* dram_home_lookup, UInt64 num_outstanding)
+{
+   // Misses and writebacks to addresses homed at our own DRAM controller (the vault underneath us) go to it directly,
+   // without NoC or directory. Everything else still goes through the directory.
+   setDRAMDirectAccess(dram_cntlr, num_outstanding);
+   m_master->m_dram_home_lookup = dram_home_lookup;
+}
+
 
 /*****************************************************************************
  * operations called by core on first-level cache
@@ -322,7 +339,8 @@ CacheCntlr::processMemOpFromCore(
       IntPtr ca_address, UInt32 offset,
       Byte* data_buf, UInt32 data_length,
       bool modeled,
-      bool count)
+      bool count,
+      IntPtr eip)
 {
    HitWhere::where_t hit_where = HitWhere::MISS;
 
@@ -589,7 +607,7 @@ MYLOG("access done");
 
    if (modeled && m_master->m_prefetcher)
    {
-      trainPrefetcher(ca_address, cache_hit, prefetch_hit, t_start);
+      trainPrefetcher(ca_address, eip, cache_hit, prefetch_hit, t_start);
    }
 
    // Call Prefetch on next-level caches (but not for atomic instructions as that causes a locking mess)
@@ -661,27 +679,24 @@ MYLOG("copyDataFromNextLevel l%d", m_mem_component);
 
 
 void
-CacheCntlr::trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, SubsecondTime t_issue)
+CacheCntlr::trainPrefetcher(IntPtr address, IntPtr eip, bool cache_hit, bool prefetch_hit, SubsecondTime t_issue)
 {
    ScopedLock sl(getLock());
 
-   // Always train the prefetcher
-   std::vector<IntPtr> prefetchList = m_master->m_prefetcher->getNextAddress(address, m_core_id);
+   // Always train the prefetcher. The queue is cleared below, so it can hold at most m_prefetch_queue_length new entries
+   UInt32 num_prefetches = m_master->m_prefetcher->getNextAddresses(address, eip, m_core_id, &m_master->m_prefetch_buffer[0], m_master->m_prefetch_queue_length);
 
    // Only do prefetches on misses, or on hits to lines previously brought in by the prefetcher (if enabled)
    if (!cache_hit || (m_prefetch_on_prefetch_hit && prefetch_hit))
    {
       m_master->m_prefetch_list.clear();
       // Just talked to the next-level cache, wait a bit before we start to prefetch
-      m_master->m_prefetch_next = t_issue + PREFETCH_INTERVAL;
+      m_master->m_prefetch_next = t_issue + m_master->m_prefetch_interval;
 
-      for(std::vector<IntPtr>::iterator it = prefetchList.begin(); it != prefetchList.end(); ++it)
+      for(UInt32 i = 0; i < num_prefetches; ++i)
       {
-         // Keep at most PREFETCH_MAX_QUEUE_LENGTH entries in the prefetch queue
-         if (m_master->m_prefetch_list.size() > PREFETCH_MAX_QUEUE_LENGTH)
-            break;
-         if (!operationPermissibleinCache(*it, Core::READ))
-            m_master->m_prefetch_list.push_back(*it);
+         if (!operationPermissibleinCache(m_master->m_prefetch_buffer[i], Core::READ))
+            m_master->m_prefetch_list.push_back(m_master->m_prefetch_buffer[i]);
       }
    }
 }
@@ -689,35 +704,44 @@ CacheCntlr::trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, S
 void
 CacheCntlr::Prefetch(SubsecondTime t_now)
 {
-   IntPtr address_to_prefetch = INVALID_ADDRESS;
-
+   // Do at most m_prefetch_issue_width prefetches now, all starting at m_prefetch_next, save the rest for a future call
+   SubsecondTime t_start = m_master->m_prefetch_next;
+   UInt32 num_issued = 0;
+   for(UInt32 i = 0; i < m_master->m_prefetch_issue_width; ++i)
    {
-      ScopedLock sl(getLock());
+      IntPtr address_to_prefetch = INVALID_ADDRESS;
 
-      if (m_master->m_prefetch_next <= t_now)
       {
-         while(!m_master->m_prefetch_list.empty())
-         {
-            IntPtr address = m_master->m_prefetch_list.front();
-            m_master->m_prefetch_list.pop_front();
+         ScopedLock sl(getLock());
 
-            // Check address again, maybe some other core already brought it into the cache
-            if (!operationPermissibleinCache(address, Core::READ))
+         if (m_master->m_prefetch_next <= t_now)
+         {
+            while(!m_master->m_prefetch_list.empty())
             {
-               address_to_prefetch = address;
-               // Do at most one prefetch now, save the rest for a future call
-               break;
+               IntPtr address = m_master->m_prefetch_list.front();
+               m_master->m_prefetch_list.pop_front();
+
+               // Check address again, maybe some other core already brought it into the cache
+               if (!operationPermissibleinCache(address, Core::READ))
+               {
+                  address_to_prefetch = address;
+                  break;
+               }
             }
          }
       }
-   }
 
-   if (address_to_prefetch != INVALID_ADDRESS)
-   {
-      doPrefetch(address_to_prefetch, m_master->m_prefetch_next);
-      atomic_add_subsecondtime(m_master->m_prefetch_next, PREFETCH_INTERVAL);
+      if (address_to_prefetch == INVALID_ADDRESS)
+         break;
+
+      doPrefetch(address_to_prefetch, t_start);
+      ++num_issued;
    }
 
+   // The next group can start one issue interval later
+   if (num_issued)
+      atomic_add_subsecondtime(m_master->m_prefetch_next, m_master->m_prefetch_interval);
+
    // In case the next-level cache has a prefetcher, run it
    if (m_next_cache_cntlr)
       m_next_cache_cntlr->Prefetch(t_now);
@@ -959,7 +983,7 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
             MYLOG("Silent upgrade from E -> M for address %lx", address);
             cache_block_info->setCState(CacheState::MODIFIED);
          }
-         else if (m_master->m_dram_cntlr)
+         else if (isDirectDramAccess(address))
          {
 
           //cout << "getHome(address): " << to_string(getHome(address)) << " m_core_id: " << to_string(m_core_id) << endl;
@@ -982,6 +1006,8 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
                // Do the DRAM access and increment local time
                boost::tie<HitWhere::where_t, SubsecondTime>(hit_where, latency) = accessDRAM(Core::READ, address, isPrefetch != Prefetch::NONE, data_buf);
                getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
+               if (m_master->m_dram_home_lookup)
+                  hit_where = HitWhere::DRAM_LOCAL;
 
                // Insert the line. Be sure to use SHARED/MODIFIED as appropriate (upgrades are free anyway), we don't want to have to write back clean lines
                insertCacheBlock(address, mem_op_type == Core::READ ? CacheState::SHARED : CacheState::MODIFIED, data_buf, m_core_id, ShmemPerfModel::_USER_THREAD);
@@ -1014,7 +1040,8 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
 
    if (modeled && m_master->m_prefetcher)
    {
-      trainPrefetcher(address, cache_hit, prefetch_hit, t_issue);
+      // The PC of the access is only known at the cache the core talks to
+      trainPrefetcher(address, 0, cache_hit, prefetch_hit, t_issue);
    }
 
    #ifdef PRIVATE_L2_OPTIMIZATION
@@ -1465,10 +1492,13 @@ MYLOG("evicting @%lx", evict_address);
          }
          m_next_cache_cntlr->notifyPrevLevelEvict(m_core_id_master, m_mem_component, evict_address);
       }
-      else if (m_master->m_dram_cntlr)
+      else if (isDirectDramAccess(evict_address))
       {
          if (evict_block_info.getCState() == CacheState::MODIFIED)
          {
+            if (m_master->m_dram_home_lookup)
+               ++stats.vault_local_writebacks;
+
             SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
 
             if (m_master->m_dram_outstanding_writebacks)
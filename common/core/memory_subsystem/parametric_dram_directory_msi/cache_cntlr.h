@@ -38,11 +38,6 @@ namespace ParametricDramDirectoryMSI
 class FaultInjector;
 class ShmemPerf;
 
-// Maximum size of the list of addresses to prefetch
-#define PREFETCH_MAX_QUEUE_LENGTH 32
-// Time between prefetches
-#define PREFETCH_INTERVAL SubsecondTime::NS(1)
-
 namespace ParametricDramDirectoryMSI
 {
    class Transition
@@ -156,6 +151,7 @@ namespace ParametricDramDirectoryMSI
          Prefetcher* m_prefetcher;
          DramCntlrInterface* m_dram_cntlr;
          ContentionModel* m_dram_outstanding_writebacks;
+         AddressHomeLookup* m_dram_home_lookup; //< Vault-local mode: only addresses homed at m_dram_cntlr bypass the directory
 
          Mshr mshr;
          ContentionModel m_l1_mshr;
@@ -172,6 +168,10 @@ namespace ParametricDramDirectoryMSI
 
          std::deque<IntPtr> m_prefetch_list;
          SubsecondTime m_prefetch_next;
+         UInt32 m_prefetch_queue_length; //< Maximum size of the list of addresses to prefetch
+         UInt32 m_prefetch_issue_width; //< Maximum number of prefetches started per issue interval
+         SubsecondTime m_prefetch_interval; //< Time between prefetches
+         std::vector<IntPtr> m_prefetch_buffer; //< Prefetcher output, m_prefetch_queue_length entries
 
          void createSetLocks(UInt32 cache_block_size, UInt32 num_sets, UInt32 core_offset, UInt32 num_cores);
          SetLock* getSetLock(IntPtr addr);
@@ -185,6 +185,7 @@ namespace ParametricDramDirectoryMSI
             , m_prefetcher(NULL)
             , m_dram_cntlr(NULL)
             , m_dram_outstanding_writebacks(NULL)
+            , m_dram_home_lookup(NULL)
             , m_l1_mshr(name + ".mshr", core_id, outstanding_misses)
             , m_next_level_read_bandwidth(name + ".next_read", core_id)
             , m_evicting_address(0)
@@ -192,6 +193,9 @@ namespace ParametricDramDirectoryMSI
             , m_atds()
             , m_prefetch_list()
             , m_prefetch_next(SubsecondTime::Zero())
+            , m_prefetch_queue_length(0)
+            , m_prefetch_issue_width(0)
+            , m_prefetch_interval(SubsecondTime::Zero())
          {}
          ~CacheMasterCntlr();
 
@@ -239,6 +243,7 @@ namespace ParametricDramDirectoryMSI
            SubsecondTime mshr_latency;
            UInt64 prefetches;
            UInt64 coherency_downgrades, coherency_upgrades, coherency_invalidates, coherency_writebacks;
+           UInt64 vault_local_writebacks;
            #ifdef ENABLE_TRANSITIONS
            UInt64 transitions[CacheState::NUM_CSTATE_SPECIAL_STATES][CacheState::NUM_CSTATE_SPECIAL_STATES];
            UInt64 transition_reasons[Transition::NUM_REASONS][CacheState::NUM_CSTATE_SPECIAL_STATES][CacheState::NUM_CSTATE_SPECIAL_STATES];
@@ -284,7 +289,7 @@ namespace ParametricDramDirectoryMSI
                IntPtr address, Core::mem_op_t mem_op_type, CacheBlockInfo **cache_block_info = NULL);
 
          void copyDataFromNextLevel(Core::mem_op_t mem_op_type, IntPtr address, bool modeled, SubsecondTime t_start);
-         void trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, SubsecondTime t_issue);
+         void trainPrefetcher(IntPtr address, IntPtr eip, bool cache_hit, bool prefetch_hit, SubsecondTime t_issue);
          void Prefetch(SubsecondTime t_start);
          void doPrefetch(IntPtr prefetch_address, SubsecondTime t_start);
 
@@ -307,6 +312,10 @@ namespace ParametricDramDirectoryMSI
          HitWhere::where_t processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, bool modeled, bool count, Prefetch::prefetch_type_t isPrefetch, SubsecondTime t_issue, bool have_write_lock);
 
          // Process Request from L1 Cache
+         bool isDirectDramAccess(IntPtr address) const
+         {
+            return m_master->m_dram_cntlr && (!m_master->m_dram_home_lookup || m_master->m_dram_home_lookup->getHome(address) == m_core_id_master);
+         }
          boost::tuple<HitWhere::where_t, SubsecondTime> accessDRAM(Core::mem_op_t mem_op_type, IntPtr address, bool isPrefetch, Byte* data_buf);
          void initiateDirectoryAccess(Core::mem_op_t mem_op_type, IntPtr address, bool isPrefetch, SubsecondTime t_issue);
          void processExReqToDirectory(IntPtr address);
@@ -371,6 +380,7 @@ namespace ParametricDramDirectoryMSI
          void setNextCacheCntlr(CacheCntlr* next_cache_cntlr) { m_next_cache_cntlr = next_cache_cntlr; }
          void createSetLocks(UInt32 cache_block_size, UInt32 num_sets, UInt32 core_offset, UInt32 num_cores) { m_master->createSetLocks(cache_block_size, num_sets, core_offset, num_cores); }
          void setDRAMDirectAccess(DramCntlrInterface* dram_cntlr, UInt64 num_outstanding);
+         void setDRAMVaultLocalAccess(DramCntlrInterface* dram_cntlr, AddressHomeLookup* dram_home_lookup, UInt64 num_outstanding);
 
          HitWhere::where_t processMemOpFromCore(
                Core::lock_signal_t lock_signal,
@@ -378,7 +388,8 @@ namespace ParametricDramDirectoryMSI
                IntPtr ca_address, UInt32 offset,
                Byte* data_buf, UInt32 data_length,
                bool modeled,
-               bool count);
+               bool count,
+               IntPtr eip = 0);
          void updateHits(Core::mem_op_t mem_op_type, UInt64 hits);
 
          // Notify next level cache of so it can update its sharing set
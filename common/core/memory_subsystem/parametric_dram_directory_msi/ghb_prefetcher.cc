@@ -135,3 +135,36 @@ GhbPrefetcher::getNextAddress(IntPtr currentAddress, core_id_t core_id)
 
    return prefetchList;
 }
+
+void
+GhbPrefetcher::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.write(m_lastAddress);
+   writer.write(m_ghbHead);
+   writer.write(m_generation);
+   writer.write(m_tableHead);
+   writer.writeArray(m_ghb);
+   writer.writeArray(m_ghbTable);
+}
+
+bool
+GhbPrefetcher::restoreCheckpoint(CheckpointReader &reader)
+{
+   // Read into copies first, so a mismatching checkpoint leaves the prefetcher unchanged
+   IntPtr last_address = reader.read<IntPtr>();
+   UInt32 ghb_head = reader.read<UInt32>();
+   UInt32 generation = reader.read<UInt32>();
+   UInt32 table_head = reader.read<UInt32>();
+   std::vector<GHBEntry> ghb(m_ghb.size());
+   std::vector<TableEntry> ghb_table(m_ghbTable.size());
+   if (!reader.readArray(ghb) || !reader.readArray(ghb_table))
+      return false;
+
+   m_lastAddress = last_address;
+   m_ghbHead = ghb_head;
+   m_generation = generation;
+   m_tableHead = table_head;
+   m_ghb.swap(ghb);
+   m_ghbTable.swap(ghb_table);
+   return true;
+}
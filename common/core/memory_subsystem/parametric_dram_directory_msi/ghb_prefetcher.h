@@ -10,6 +10,8 @@ class GhbPrefetcher : public Prefetcher
       std::vector<IntPtr> getNextAddress(IntPtr currentAddress, core_id_t core_id);
 
       ~GhbPrefetcher();
+      void saveCheckpoint(CheckpointWriter &writer);
+      bool restoreCheckpoint(CheckpointReader &reader);
 
    private:
       static const SInt64 INVALID_DELTA = INT64_MAX;
@@ -30,6 +30,9 @@ namespace ParametricDramDirectoryMSI
 
 std::map<CoreComponentType, CacheCntlr*> MemoryManager::m_all_cache_cntlrs;
 
+// Outgoing messages up to this size (all of them, unless cache lines are very large) are built on the stack
+static const UInt32 MSG_BUF_LOCAL_SIZE = 256;
+
 MemoryManager::MemoryManager(Core* core,
       Network* network, ShmemPerfModel* shmem_perf_model):
    MemoryManagerBase(core, network, shmem_perf_model),
@@ -57,6 +60,7 @@ MemoryManager::MemoryManager(Core* core,
 
    UInt32 smt_cores;
    bool dram_direct_access = false;
+   bool dram_vault_local = false;
    UInt32 dram_directory_total_entries = 0;
    UInt32 dram_directory_associativity = 0;
    UInt32 dram_directory_max_num_sharers = 0;
@@ -181,6 +185,7 @@ MemoryManager::MemoryManager(Core* core,
 
       // Dram Cntlr
       dram_direct_access = Sim()->getCfg()->getBool("perf_model/dram/direct_access");
+      dram_vault_local = Sim()->getCfg()->getBool("perf_model/dram/vault_local");
    }
    catch(...)
    {
@@ -384,6 +389,14 @@ MemoryManager::MemoryManager(Core* core,
             m_dram_cache ? (DramCntlrInterface*)m_dram_cache : (DramCntlrInterface*)m_dram_cntlr,
             Sim()->getCfg()->getInt("perf_model/llc/evict_buffers"));
       }
+      else if (dram_vault_local && m_dram_cntlr && getCore()->getId() < (core_id_t)Sim()->getConfig()->getApplicationCores())
+      {
+         LOG_ASSERT_ERROR(cache_parameters[m_last_level_cache].shared_cores == 1, "DRAM vault-local access requires a private last-level cache (LLC level %d shared by %d)", m_last_level_cache, cache_parameters[m_last_level_cache].shared_cores);
+         m_cache_cntlrs[(UInt32)m_last_level_cache]->setDRAMVaultLocalAccess(
+            m_dram_cache ? (DramCntlrInterface*)m_dram_cache : (DramCntlrInterface*)m_dram_cntlr,
+            m_dram_controller_home_lookup,
+            Sim()->getCfg()->getInt("perf_model/llc/evict_buffers"));
+      }
    }
 
    // Register Call-backs
@@ -439,7 +452,8 @@ MemoryManager::coreInitiateMemoryAccess(
       Core::mem_op_t mem_op_type,
       IntPtr address, UInt32 offset,
       Byte* data_buf, UInt32 data_length,
-      Core::MemModeled modeled)
+      Core::MemModeled modeled,
+      IntPtr eip)
 {
    LOG_ASSERT_ERROR(mem_component <= m_last_level_cache,
       "Error: invalid mem_component (%d) for coreInitiateMemoryAccess", mem_component);
@@ -455,7 +469,8 @@ MemoryManager::coreInitiateMemoryAccess(
          address, offset,
          data_buf, data_length,
          modeled == Core::MEM_MODELED_NONE || modeled == Core::MEM_MODELED_COUNT ? false : true,
-         modeled == Core::MEM_MODELED_NONE ? false : true);
+         modeled == Core::MEM_MODELED_NONE ? false : true,
+         eip);
 }
 
 void
@@ -463,7 +478,8 @@ MemoryManager::handleMsgFromNetwork(NetPacket& packet)
 {
 MYLOG("begin");
    core_id_t sender = packet.sender;
-   PrL1PrL2DramDirectoryMSI::ShmemMsg* shmem_msg = PrL1PrL2DramDirectoryMSI::ShmemMsg::getShmemMsg((Byte*) packet.data, &m_dummy_shmem_perf);
+   // The network keeps the packet's buffer alive until we return, so there is no need to copy the message out of it
+   PrL1PrL2DramDirectoryMSI::ShmemMsg* shmem_msg = PrL1PrL2DramDirectoryMSI::ShmemMsg::getShmemMsgInPlace((Byte*) packet.data);
    SubsecondTime msg_time = packet.time;
 
    getShmemPerfModel()->setElapsedTime(ShmemPerfModel::_SIM_THREAD, msg_time);
@@ -540,16 +556,6 @@ MYLOG("begin");
          break;
    }
 
-   // Delete the allocated Shared Memory Message
-   // First delete 'data_buf' if it is present
-   // LOG_PRINT("Finished handling Shmem Msg");
-
-   if (shmem_msg->getDataLength() > 0)
-   {
-      assert(shmem_msg->getDataBuf());
-      delete [] shmem_msg->getDataBuf();
-   }
-   delete shmem_msg;
 MYLOG("end");
 }
 
@@ -562,7 +568,10 @@ MYLOG("send msg %u %ul%u > %ul%u", msg_type, requester, sender_mem_component, re
    PrL1PrL2DramDirectoryMSI::ShmemMsg shmem_msg(msg_type, sender_mem_component, receiver_mem_component, requester, address, data_buf, data_length, perf);
    shmem_msg.setWhere(where);
 
-   Byte* msg_buf = shmem_msg.makeMsgBuf();
+   // Build the message on the stack, netSend copies it into a transport buffer
+   Byte msg_buf_local[MSG_BUF_LOCAL_SIZE];
+   Byte* msg_buf = shmem_msg.getMsgLen() <= sizeof(msg_buf_local) ? msg_buf_local : new Byte[shmem_msg.getMsgLen()];
+   shmem_msg.makeMsgBuf(msg_buf);
    SubsecondTime msg_time = getShmemPerfModel()->getElapsedTime(thread_num);
    perf->updateTime(msg_time);
 
@@ -578,8 +587,8 @@ MYLOG("send msg %u %ul%u > %ul%u", msg_type, requester, sender_mem_component, re
 //cout << "pkt_len: " << to_string(pkt_len) << endl;
 //cout << "shmem_msg.getMsgLen(): " << to_string(shmem_msg.getMsgLen()) << endl; // 56 or 120
 //cout << "" << endl;
-// Delete the Msg Buf
-   delete [] msg_buf;
+   if (msg_buf != msg_buf_local)
+      delete [] msg_buf;
 }
 
 void
@@ -589,7 +598,10 @@ MYLOG("bcast msg");
    assert((data_buf == NULL) == (data_length == 0));
    PrL1PrL2DramDirectoryMSI::ShmemMsg shmem_msg(msg_type, sender_mem_component, receiver_mem_component, requester, address, data_buf, data_length, perf);
 
-   Byte* msg_buf = shmem_msg.makeMsgBuf();
+   // Build the message on the stack, netSend copies it into a transport buffer
+   Byte msg_buf_local[MSG_BUF_LOCAL_SIZE];
+   Byte* msg_buf = shmem_msg.getMsgLen() <= sizeof(msg_buf_local) ? msg_buf_local : new Byte[shmem_msg.getMsgLen()];
+   shmem_msg.makeMsgBuf(msg_buf);
    SubsecondTime msg_time = getShmemPerfModel()->getElapsedTime(thread_num);
    perf->updateTime(msg_time);
 
@@ -603,8 +615,8 @@ MYLOG("bcast msg");
          shmem_msg.getMsgLen(), (const void*) msg_buf);
    getNetwork()->netSend(packet);
 
-   // Delete the Msg Buf
-   delete [] msg_buf;
+   if (msg_buf != msg_buf_local)
+      delete [] msg_buf;
 }
 
 void
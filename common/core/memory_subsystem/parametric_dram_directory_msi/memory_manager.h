@@ -88,7 +88,8 @@ namespace ParametricDramDirectoryMSI
                Core::mem_op_t mem_op_type,
                IntPtr address, UInt32 offset,
                Byte* data_buf, UInt32 data_length,
-               Core::MemModeled modeled);
+               Core::MemModeled modeled,
+               IntPtr eip);
 
          void handleMsgFromNetwork(NetPacket& packet);
 
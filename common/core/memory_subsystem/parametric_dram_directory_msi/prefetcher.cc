@@ -4,15 +4,34 @@
 #include "log.h"
 #include "simple_prefetcher.h"
 #include "ghb_prefetcher.h"
+#include "stride_prefetcher.h"
 
-Prefetcher* Prefetcher::createPrefetcher(String type, String configName, core_id_t core_id, UInt32 shared_cores)
+#include <algorithm>
+
+Prefetcher* Prefetcher::createPrefetcher(String type, String configName, core_id_t core_id, UInt32 shared_cores, UInt32 cache_block_size)
 {
+   Prefetcher *prefetcher = NULL;
    if (type == "none")
       return NULL;
    else if (type == "simple")
-      return new SimplePrefetcher(configName, core_id, shared_cores);
+      prefetcher = new SimplePrefetcher(configName, core_id, shared_cores);
    else if (type == "ghb")
-      return new GhbPrefetcher(configName, core_id);
+      prefetcher = new GhbPrefetcher(configName, core_id);
+   else if (type == "stride")
+      prefetcher = new StridePrefetcher(configName, core_id, cache_block_size);
+   else
+   {
+      LOG_PRINT_ERROR("Invalid prefetcher type %s", type.c_str());
+   }
+
+   Sim()->getCheckpointManager()->registerObject(configName + "/prefetcher", core_id, prefetcher);
+   return prefetcher;
+}
 
-   LOG_PRINT_ERROR("Invalid prefetcher type %s", type.c_str());
+UInt32 Prefetcher::getNextAddresses(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses)
+{
+   std::vector<IntPtr> prefetchList = getNextAddress(current_address, core_id);
+   UInt32 num_addresses = std::min((UInt32)prefetchList.size(), max_addresses);
+   std::copy(prefetchList.begin(), prefetchList.begin() + num_addresses, addresses);
+   return num_addresses;
 }
@@ -2,15 +2,24 @@
 #define PREFETCHER_H
 
 #include "fixed_types.h"
+#include "checkpoint_manager.h"
 
 #include <vector>
 
-class Prefetcher
+class Prefetcher : public Checkpointable
 {
    public:
-      static Prefetcher* createPrefetcher(String type, String configName, core_id_t core_id, UInt32 shared_cores);
+      static Prefetcher* createPrefetcher(String type, String configName, core_id_t core_id, UInt32 shared_cores, UInt32 cache_block_size);
 
       virtual std::vector<IntPtr> getNextAddress(IntPtr current_address, core_id_t core_id) = 0;
+
+      // Train on an access and write at most max_addresses addresses to prefetch into the caller's buffer, returns how many were written.
+      // eip is the PC of the access, or zero when unknown. By default, this copies the result of getNextAddress.
+      virtual UInt32 getNextAddresses(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses);
+
+      // Training state, saved in checkpoints
+      virtual void saveCheckpoint(CheckpointWriter &writer) {}
+      virtual bool restoreCheckpoint(CheckpointReader &reader) { return true; }
 };
 
 #endif // PREFETCHER_H
@@ -62,3 +62,27 @@ SimplePrefetcher::getNextAddress(IntPtr current_address, core_id_t _core_id)
 
    return addresses;
 }
+
+void
+SimplePrefetcher::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.write(n_flow_next);
+   for(UInt32 idx = 0; idx < m_prev_address.size(); ++idx)
+      writer.writeArray(m_prev_address[idx]);
+}
+
+bool
+SimplePrefetcher::restoreCheckpoint(CheckpointReader &reader)
+{
+   // Read into copies first, so a mismatching checkpoint leaves the prefetcher unchanged
+   UInt32 flow_next = reader.read<UInt32>();
+   if (flow_next >= n_flows)
+      return false;
+   std::vector<std::vector<IntPtr> > prev_address(m_prev_address);
+   for(UInt32 idx = 0; idx < prev_address.size(); ++idx)
+      if (!reader.readArray(prev_address[idx]))
+         return false;
+   n_flow_next = flow_next;
+   m_prev_address.swap(prev_address);
+   return true;
+}
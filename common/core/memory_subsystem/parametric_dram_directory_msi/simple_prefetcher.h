@@ -8,6 +8,8 @@ class SimplePrefetcher : public Prefetcher
    public:
       SimplePrefetcher(String configName, core_id_t core_id, UInt32 shared_cores);
       virtual std::vector<IntPtr> getNextAddress(IntPtr current_address, core_id_t core_id);
+      void saveCheckpoint(CheckpointWriter &writer);
+      bool restoreCheckpoint(CheckpointReader &reader);
 
    private:
       const core_id_t core_id;
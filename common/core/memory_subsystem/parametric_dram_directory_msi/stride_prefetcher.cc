@@ -0,0 +1,152 @@
+#include "stride_prefetcher.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "log.h"
+#include "utils.h"
+
+static const IntPtr PAGE_SIZE = 4096;
+static const IntPtr PAGE_MASK = ~(PAGE_SIZE-1);
+
+StridePrefetcher::StridePrefetcher(String configName, core_id_t core_id, UInt32 cache_block_size)
+   : m_log_block_size(floorLog2(cache_block_size))
+   , m_degree(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stride/degree", core_id))
+   , m_stop_at_page(Sim()->getCfg()->getBoolArray("perf_model/" + configName + "/prefetcher/stride/stop_at_page_boundary", core_id))
+   , m_stride_table(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stride/table_size", core_id))
+   , m_streams(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stride/streams", core_id))
+   , m_num_accesses(0)
+{
+   LOG_ASSERT_ERROR(m_stride_table.size() > 0 && m_degree > 0, "Stride prefetcher needs a table_size and degree of at least one");
+}
+
+bool
+StridePrefetcher::trainStride(IntPtr current_address, IntPtr eip, SInt64 &stride)
+{
+   IntPtr tag = eip ? eip : (current_address & PAGE_MASK);
+   StrideEntry &entry = m_stride_table[(tag ^ (tag >> 12)) % m_stride_table.size()];
+
+   if (entry.tag != tag)
+   {
+      entry.tag = tag;
+      entry.last_address = current_address;
+      entry.stride = 0;
+      entry.confidence = 0;
+      return false;
+   }
+
+   SInt64 new_stride = current_address - entry.last_address;
+   entry.last_address = current_address;
+   if (new_stride == 0)
+      // Another access to the same line (the caches only see line addresses), this says nothing about the stride
+      return false;
+
+   if (new_stride == entry.stride)
+   {
+      if (entry.confidence < CONFIDENCE_MAX)
+         ++entry.confidence;
+   }
+   else if (entry.confidence > 0)
+      --entry.confidence;
+   else
+      entry.stride = new_stride;
+
+   stride = entry.stride;
+   return entry.confidence >= CONFIDENCE_THRESHOLD;
+}
+
+bool
+StridePrefetcher::trainStream(IntPtr current_address, SInt64 &stride)
+{
+   IntPtr line = current_address >> m_log_block_size;
+   ++m_num_accesses;
+
+   Stream *victim = NULL;
+   for(std::vector<Stream>::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+   {
+      if (it->last_line != INVALID_ADDRESS)
+      {
+         SInt64 delta = line - it->last_line;
+         if (delta == 0)
+         {
+            it->last_used = m_num_accesses;
+            return false;
+         }
+         else if ((it->direction == 0 && (delta == 1 || delta == -1)) || (it->direction != 0 && delta == it->direction))
+         {
+            it->direction = delta;
+            it->last_line = line;
+            it->last_used = m_num_accesses;
+            stride = delta * (SInt64(1) << m_log_block_size);
+            return true;
+         }
+      }
+      if (!victim || it->last_used < victim->last_used)
+         victim = &*it;
+   }
+
+   // No stream matched: start a new one, it is confirmed when the next or previous line is accessed
+   if (victim)
+   {
+      victim->last_line = line;
+      victim->direction = 0;
+      victim->last_used = m_num_accesses;
+   }
+   return false;
+}
+
+UInt32
+StridePrefetcher::getNextAddresses(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses)
+{
+   // Always train both, but prefer the stride table when it is confident
+   SInt64 stride = 0, stream_stride = 0;
+   bool have_stride = trainStride(current_address, eip, stride);
+   bool have_stream = trainStream(current_address, stream_stride);
+   if (!have_stride)
+   {
+      if (!have_stream)
+         return 0;
+      stride = stream_stride;
+   }
+
+   UInt32 num_addresses = 0;
+   for(UInt32 i = 1; i <= m_degree && num_addresses < max_addresses; ++i)
+   {
+      IntPtr prefetch_address = current_address + i * stride;
+      // But stay within the page if requested
+      if (m_stop_at_page && ((prefetch_address & PAGE_MASK) != (current_address & PAGE_MASK)))
+         break;
+      addresses[num_addresses++] = prefetch_address;
+   }
+   return num_addresses;
+}
+
+std::vector<IntPtr>
+StridePrefetcher::getNextAddress(IntPtr current_address, core_id_t core_id)
+{
+   std::vector<IntPtr> addresses(m_degree);
+   addresses.resize(getNextAddresses(current_address, 0, core_id, &addresses[0], m_degree));
+   return addresses;
+}
+
+void
+StridePrefetcher::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.write(m_num_accesses);
+   writer.writeArray(m_stride_table);
+   writer.writeArray(m_streams);
+}
+
+bool
+StridePrefetcher::restoreCheckpoint(CheckpointReader &reader)
+{
+   // Read into copies first, so a mismatching checkpoint leaves the prefetcher unchanged
+   UInt64 num_accesses = reader.read<UInt64>();
+   std::vector<StrideEntry> stride_table(m_stride_table.size());
+   std::vector<Stream> streams(m_streams.size());
+   if (!reader.readArray(stride_table) || !reader.readArray(streams))
+      return false;
+
+   m_num_accesses = num_accesses;
+   m_stride_table.swap(stride_table);
+   m_streams.swap(streams);
+   return true;
+}
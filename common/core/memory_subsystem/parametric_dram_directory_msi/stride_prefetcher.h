@@ -0,0 +1,51 @@
+#ifndef __STRIDE_PREFETCHER_H
+#define __STRIDE_PREFETCHER_H
+
+#include "prefetcher.h"
+
+// Stride prefetcher with a per-PC stride table and a set of stream buffers.
+// The stride table catches regular strides of individual load/store instructions, the stream
+// buffers catch sequential streams made up of accesses by different instructions (e.g. unrolled loops).
+// Caches below the L1 do not see the PC of the access, there the stride table tracks 4 KB regions instead.
+class StridePrefetcher : public Prefetcher
+{
+   public:
+      StridePrefetcher(String configName, core_id_t core_id, UInt32 cache_block_size);
+      virtual std::vector<IntPtr> getNextAddress(IntPtr current_address, core_id_t core_id);
+      virtual UInt32 getNextAddresses(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses);
+      void saveCheckpoint(CheckpointWriter &writer);
+      bool restoreCheckpoint(CheckpointReader &reader);
+
+   private:
+      static const UInt32 CONFIDENCE_MAX = 3;
+      static const UInt32 CONFIDENCE_THRESHOLD = 2;
+
+      struct StrideEntry
+      {
+         IntPtr tag;
+         IntPtr last_address;
+         SInt64 stride;
+         UInt32 confidence;
+         StrideEntry() : tag(INVALID_ADDRESS), last_address(0), stride(0), confidence(0) {}
+      };
+
+      struct Stream
+      {
+         IntPtr last_line;
+         SInt64 direction; // In cache lines: +1 or -1 once confirmed, 0 while waiting for a second access
+         UInt64 last_used;
+         Stream() : last_line(INVALID_ADDRESS), direction(0), last_used(0) {}
+      };
+
+      const UInt32 m_log_block_size;
+      const UInt32 m_degree;
+      const bool m_stop_at_page;
+      std::vector<StrideEntry> m_stride_table;
+      std::vector<Stream> m_streams;
+      UInt64 m_num_accesses;
+
+      bool trainStride(IntPtr current_address, IntPtr eip, SInt64 &stride);
+      bool trainStream(IntPtr current_address, SInt64 &stride);
+};
+
+#endif // __STRIDE_PREFETCHER_H
@@ -6,6 +6,9 @@
 #include "stats.h"
 #include "fault_injection.h"
 #include "shmem_perf.h"
+#include "hmc_address_map.h"
+#include "dram_trace.h"
+#include "itostr.h"
 
 #if 0
    extern Lock iolock;
@@ -27,6 +30,8 @@ DramCntlr::DramCntlr(MemoryManagerBase* memory_manager,
    : DramCntlrInterface(memory_manager, shmem_perf_model, cache_block_size)
    , m_reads(0)
    , m_writes(0)
+   , m_hmc_map(NULL)
+   , m_dram_trace(DramTrace::getSingleton())
 {
    cout << "[LINGXI]: in /common/core/mem_sub/pr_l1_pr_l2_drm_dir_msi/dram_cntrl. core_id: " << memory_manager->getCore()->getId() << endl;
    m_dram_perf_model = DramPerfModel::createDramPerfModel(
@@ -40,6 +45,14 @@ DramCntlr::DramCntlr(MemoryManagerBase* memory_manager,
    m_dram_access_count = new AccessCountMap[DramCntlrInterface::NUM_ACCESS_TYPES];
    registerStatsMetric("dram", memory_manager->getCore()->getId(), "reads", &m_reads);
    registerStatsMetric("dram", memory_manager->getCore()->getId(), "writes", &m_writes);
+
+   if (HmcAddressMap::getSingleton()->isEnabled())
+   {
+      m_hmc_map = HmcAddressMap::getSingleton();
+      m_bank_accesses.resize(m_hmc_map->getBanksPerVault(), 0);
+      for(UInt32 bank = 0; bank < m_bank_accesses.size(); ++bank)
+         registerStatsMetric("dram", memory_manager->getCore()->getId(), "bank_accesses[" + itostr(bank) + "]", &m_bank_accesses[bank]);
+   }
 }
 
 DramCntlr::~DramCntlr()
@@ -53,7 +66,9 @@ DramCntlr::~DramCntlr()
 boost::tuple<SubsecondTime, HitWhere::where_t>
 DramCntlr::getDataFromDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now, ShmemPerf *perf)
 {
-   if (Sim()->getFaultinjectionManager())
+   ScopedLock sl(m_lock);
+
+   if (!Sim()->isTimingOnlyMemory())
    {
       if (m_data_map.count(address) == 0)
       {
@@ -85,7 +100,9 @@ DramCntlr::getDataFromDram(IntPtr address, core_id_t requester, Byte* data_buf,
 boost::tuple<SubsecondTime, HitWhere::where_t>
 DramCntlr::putDataToDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now)
 {
-   if (Sim()->getFaultinjectionManager())
+   ScopedLock sl(m_lock);
+
+   if (!Sim()->isTimingOnlyMemory())
    {
       if (m_data_map[address] == NULL)
       {
@@ -98,6 +115,8 @@ DramCntlr::putDataToDram(IntPtr address, core_id_t requester, Byte* data_buf, Su
          m_fault_injector->postWrite(address, address, getCacheBlockSize(), (Byte*)m_data_map[address], now);
    }
 
+   // Writebacks are off the critical path, the dummy is only used to get the latency breakdown for the DRAM trace
+   m_dummy_shmem_perf.reset(now, requester);
    SubsecondTime dram_access_latency = runDramPerfModel(requester, now, address, WRITE, &m_dummy_shmem_perf);
 
    ++m_writes;
@@ -118,7 +137,25 @@ DramCntlr::runDramPerfModel(core_id_t requester, SubsecondTime time, IntPtr addr
 //		" type: " << to_string(access_type) << endl;
 	}
 
+   if (m_hmc_map)
+      ++m_bank_accesses[m_hmc_map->getBank(address)];
+
    UInt64 pkt_size = getCacheBlockSize();
+
+   if (m_dram_trace)
+   {
+      // The DRAM model adds its latency components to perf, record only what this access contributed
+      SubsecondTime queue = perf->getComponent(ShmemPerf::DRAM_QUEUE),
+                    bus = perf->getComponent(ShmemPerf::DRAM_BUS),
+                    device = perf->getComponent(ShmemPerf::DRAM_DEVICE);
+      SubsecondTime dram_access_latency = m_dram_perf_model->getAccessLatency(time, pkt_size, requester, address, access_type, perf);
+      m_dram_trace->record(m_memory_manager->getCore()->getId(), requester, time, address, access_type, dram_access_latency,
+         perf->getComponent(ShmemPerf::DRAM_QUEUE) - queue,
+         perf->getComponent(ShmemPerf::DRAM_BUS) - bus,
+         perf->getComponent(ShmemPerf::DRAM_DEVICE) - device);
+      return dram_access_latency;
+   }
+
    SubsecondTime dram_access_latency = m_dram_perf_model->getAccessLatency(time, pkt_size, requester, address, access_type, perf);
    return dram_access_latency;
 }
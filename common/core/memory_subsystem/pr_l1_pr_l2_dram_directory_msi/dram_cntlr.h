@@ -4,6 +4,7 @@
 //#define ENABLE_DRAM_ACCESS_COUNT
 
 #include <unordered_map>
+#include <vector>
 
 #include "dram_perf_model.h"
 #include "shmem_msg.h"
@@ -12,8 +13,10 @@
 #include "memory_manager_base.h"
 #include "dram_cntlr_interface.h"
 #include "subsecond_time.h"
+#include "lock.h"
 
 class FaultInjector;
+class DramTrace;
 
 namespace PrL1PrL2DramDirectoryMSI
 {
@@ -27,9 +30,16 @@ namespace PrL1PrL2DramDirectoryMSI
          typedef std::unordered_map<IntPtr,UInt64> AccessCountMap;
          AccessCountMap* m_dram_access_count;
          UInt64 m_reads, m_writes;
+         // Per-bank access counts, only tracked when HMC address mapping is enabled
+         const HmcAddressMap* m_hmc_map;
+         std::vector<UInt64> m_bank_accesses;
+         DramTrace* m_dram_trace;
 
          ShmemPerf m_dummy_shmem_perf; 
 
+         // In vault-local mode, the local LLC calls us directly while the directory does so for all other cores
+         Lock m_lock;
+
          SubsecondTime runDramPerfModel(core_id_t requester, SubsecondTime time, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf);
 
          void addToDramAccessCount(IntPtr address, access_t access_type);
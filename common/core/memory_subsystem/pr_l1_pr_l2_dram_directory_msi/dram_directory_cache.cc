@@ -1,7 +1,10 @@
 #include "dram_directory_cache.h"
+#include "simulator.h"
 #include "log.h"
 #include "utils.h"
 
+#include <algorithm>
+
 namespace PrL1PrL2DramDirectoryMSI
 {
 
@@ -25,11 +28,13 @@ DramDirectoryCache::DramDirectoryCache(
 
    // Instantiate the directory
    m_directory = new Directory(core_id, directory_type_str, total_entries, max_hw_sharers, max_num_sharers);
-   m_replacement_ptrs = new UInt32[m_num_sets];
+   m_replacement_ptrs = new UInt32[m_num_sets]();
 
    // Logs
    m_log_num_sets = floorLog2(m_num_sets);
    m_log_cache_block_size = floorLog2(m_cache_block_size);
+
+   Sim()->getCheckpointManager()->registerObject("directory", core_id, this);
 }
 
 DramDirectoryCache::~DramDirectoryCache()
@@ -120,11 +125,10 @@ DramDirectoryCache::replaceDirectoryEntry(IntPtr replaced_address, IntPtr addres
       DirectoryEntry* replaced_directory_entry = m_directory->getDirectoryEntry(set_index * m_associativity + i);
       if (replaced_directory_entry->getAddress() == replaced_address)
       {
-         m_replaced_directory_entry_list.push_back(replaced_directory_entry);
+         m_replaced_directory_entry_list.push_back(m_directory->replaceDirectoryEntry(set_index * m_associativity + i));
 
-         DirectoryEntry* directory_entry = m_directory->createDirectoryEntry();
+         DirectoryEntry* directory_entry = m_directory->getDirectoryEntry(set_index * m_associativity + i);
          directory_entry->setAddress(address);
-         m_directory->setDirectoryEntry(set_index * m_associativity + i, directory_entry);
 
          return directory_entry;
       }
@@ -162,4 +166,22 @@ DramDirectoryCache::splitAddress(IntPtr address, IntPtr& tag, UInt32& set_index)
 
 }
 
+void
+DramDirectoryCache::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.writeArray(m_replacement_ptrs, m_num_sets);
+   m_directory->saveCheckpoint(writer);
+}
+
+bool
+DramDirectoryCache::restoreCheckpoint(CheckpointReader &reader)
+{
+   // The directory leaves itself unchanged when the checkpoint does not match, only then update the replacement pointers
+   std::vector<UInt32> replacement_ptrs(m_num_sets);
+   if (!reader.readArray(replacement_ptrs) || !m_directory->restoreCheckpoint(reader))
+      return false;
+   std::copy(replacement_ptrs.begin(), replacement_ptrs.end(), m_replacement_ptrs);
+   return true;
+}
+
 }
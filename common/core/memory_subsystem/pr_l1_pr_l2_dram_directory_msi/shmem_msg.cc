@@ -1,10 +1,15 @@
 #include <string.h>
 #include "shmem_msg.h"
 #include "shmem_perf.h"
+#include "simulator.h"
 #include "log.h"
 
 namespace PrL1PrL2DramDirectoryMSI
 {
+   // In timing-only mode, messages do not carry their data payload. Received messages with a payload point here instead,
+   // so the protocol still sees a data buffer where it expects one. Nothing reads the contents.
+   static Byte s_timing_only_data_buf[4096];
+
    ShmemMsg::ShmemMsg(ShmemPerf* perf) :
       m_msg_type(INVALID_MSG_TYPE),
       m_sender_mem_component(MemComponent::INVALID_MEM_COMPONENT),
@@ -55,7 +60,12 @@ namespace PrL1PrL2DramDirectoryMSI
    {
       ShmemMsg* shmem_msg = new ShmemMsg(perf);
       memcpy((void*) shmem_msg, msg_buf, sizeof(*shmem_msg));
-      if (shmem_msg->getDataLength() > 0)
+      if (shmem_msg->getDataLength() > 0 && Sim()->isTimingOnlyMemory())
+      {
+         LOG_ASSERT_ERROR(shmem_msg->getDataLength() <= sizeof(s_timing_only_data_buf), "Data length (%u) too large", shmem_msg->getDataLength());
+         shmem_msg->setDataBuf(s_timing_only_data_buf);
+      }
+      else if (shmem_msg->getDataLength() > 0)
       {
          shmem_msg->setDataBuf(new Byte[shmem_msg->getDataLength()]);
          memcpy((void*) shmem_msg->getDataBuf(), msg_buf + sizeof(*shmem_msg), shmem_msg->getDataLength());
@@ -63,24 +73,46 @@ namespace PrL1PrL2DramDirectoryMSI
       return shmem_msg;
    }
 
+   ShmemMsg*
+   ShmemMsg::getShmemMsgInPlace(Byte* msg_buf)
+   {
+      ShmemMsg* shmem_msg = (ShmemMsg*) msg_buf;
+      if (shmem_msg->getDataLength() > 0 && Sim()->isTimingOnlyMemory())
+      {
+         LOG_ASSERT_ERROR(shmem_msg->getDataLength() <= sizeof(s_timing_only_data_buf), "Data length (%u) too large", shmem_msg->getDataLength());
+         shmem_msg->setDataBuf(s_timing_only_data_buf);
+      }
+      else if (shmem_msg->getDataLength() > 0)
+      {
+         shmem_msg->setDataBuf(msg_buf + sizeof(*shmem_msg));
+      }
+      return shmem_msg;
+   }
+
    Byte*
    ShmemMsg::makeMsgBuf()
    {
       Byte* msg_buf = new Byte[getMsgLen()];
+      makeMsgBuf(msg_buf);
+      return msg_buf;
+   }
+
+   void
+   ShmemMsg::makeMsgBuf(Byte* msg_buf)
+   {
       memcpy(msg_buf, (void*) this, sizeof(*this));
-      if (m_data_length > 0)
+      if (m_data_length > 0 && !Sim()->isTimingOnlyMemory())
       {
          LOG_ASSERT_ERROR(m_data_buf != NULL, "m_data_buf(%p)", m_data_buf);
          memcpy(msg_buf + sizeof(*this), (void*) m_data_buf, m_data_length);
       }
-
-      return msg_buf;
    }
 
    UInt32
    ShmemMsg::getMsgLen()
    {
-      return (sizeof(*this) + m_data_length);
+      // The modeled length (see getModeledLength) always includes the data, only the simulator-internal message drops it
+      return (sizeof(*this) + (Sim()->isTimingOnlyMemory() ? 0 : m_data_length));
    }
 
    UInt32
@@ -67,7 +67,10 @@ namespace PrL1PrL2DramDirectoryMSI
          ~ShmemMsg();
 
          static ShmemMsg* getShmemMsg(Byte* msg_buf, ShmemPerf* perf);
+         // Use a received message where it is, valid for as long as msg_buf is
+         static ShmemMsg* getShmemMsgInPlace(Byte* msg_buf);
          Byte* makeMsgBuf();
+         void makeMsgBuf(Byte* msg_buf);
          UInt32 getMsgLen();
 
          // Modeling
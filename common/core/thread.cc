@@ -56,6 +56,11 @@ bool Thread::reschedule(SubsecondTime &time, Core *current_core)
 {
    if (m_core == NULL || current_core != m_core)
    {
+      // If the old core simulates instructions on its own thread, let it finish the ones we queued there.
+      // Do this before taking the thread manager lock, the core thread may need it to get through the barrier.
+      if (current_core)
+         current_core->getPerformanceModel()->drain();
+
       // While we're not scheduled on a core, wait.
       // Keep time updated with the time when we return.
       ScopedLock sl(Sim()->getThreadManager()->getLock());
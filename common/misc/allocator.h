@@ -4,6 +4,7 @@
 #include "fixed_types.h"
 #include "FSBAllocator.hh"
 
+#include <vector>
 #include <typeinfo>
 #include <cxxabi.h>
 
@@ -11,7 +12,7 @@
 
 class Allocator
 {
-   private:
+   protected:
       struct DataElement
       {
           Allocator *allocator;
@@ -73,4 +74,151 @@ template <typename T, unsigned MaxItems = 0> class TypedAllocator : public Alloc
       }
 };
 
+// Pool allocator with a separate pool per allocating thread.
+// Elements are always returned to the pool they came from. Frees by the allocating thread go straight
+// back into its pool, without locking or atomic operations. Frees by any other thread (in ROB-SMT,
+// or when perf_model/core/own_thread has the core thread delete instructions queued by the application thread)
+// are pushed onto a lock-free list owned by the pool, which its thread moves back into the pool on its next alloc.
+
+template <typename T, unsigned MaxItems = 0> class ThreadLocalAllocator : public Allocator
+{
+   private:
+      class Heap : public Allocator
+      {
+         private:
+            const void* const m_owner;
+            UInt64 m_items;
+            FSBAllocator_ElemAllocator<sizeof(DataElement) + sizeof(T), MaxItems, T> m_alloc;
+            // Elements free'd by other threads, linked through their data
+            DataElement* volatile m_remote_free;
+
+            void reclaim()
+            {
+               DataElement *elem = __atomic_exchange_n(&m_remote_free, (DataElement*)NULL, __ATOMIC_ACQUIRE);
+               while (elem)
+               {
+                  DataElement *next = *(DataElement**)elem->data;
+                  --m_items;
+                  m_alloc.deallocate((T*)elem);
+                  elem = next;
+               }
+            }
+
+         public:
+            Heap(const void *owner)
+               : m_owner(owner)
+               , m_items(0)
+               , m_remote_free(NULL)
+            {}
+
+            virtual ~Heap()
+            {}
+
+            const void* getOwner() const { return m_owner; }
+            UInt64 getItems() { reclaim(); return m_items; }
+
+            virtual void* alloc(size_t bytes)
+            {
+               if (__atomic_load_n(&m_remote_free, __ATOMIC_RELAXED))
+                  reclaim();
+               ++m_items;
+               DataElement *elem = (DataElement *)m_alloc.allocate();
+               elem->allocator = this;
+               return elem->data;
+            }
+
+            virtual void _dealloc(void* ptr)
+            {
+               if (m_owner == ThreadLocalAllocator::getThreadToken())
+               {
+                  --m_items;
+                  m_alloc.deallocate((T*)ptr);
+               }
+               else
+               {
+                  DataElement *elem = (DataElement*)ptr;
+                  DataElement *head = __atomic_load_n(&m_remote_free, __ATOMIC_RELAXED);
+                  do
+                  {
+                     *(DataElement**)elem->data = head;
+                  }
+                  while (!__atomic_compare_exchange_n(&m_remote_free, &head, elem, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+               }
+            }
+      };
+
+      // Last heap used by this thread, saves a lookup in m_heaps for every alloc.
+      // Allocators are identified by a unique id rather than their address, which could be reused.
+      static UInt64 s_next_id;
+      static __thread UInt64 t_last_id;
+      static __thread Heap *t_last_heap;
+      // Only its address is used, to identify the current thread
+      static __thread char t_thread_token;
+
+      static const void* getThreadToken() { return &t_thread_token; }
+
+      const UInt64 m_id;
+      std::vector<Heap*> m_heaps;
+      Lock m_lock;
+
+      Heap* getHeap()
+      {
+         if (t_last_id == m_id)
+            return t_last_heap;
+
+         ScopedLock sl(m_lock);
+         Heap *heap = NULL;
+         for(typename std::vector<Heap*>::iterator it = m_heaps.begin(); it != m_heaps.end(); ++it)
+            if ((*it)->getOwner() == getThreadToken())
+               heap = *it;
+         if (!heap)
+         {
+            heap = new Heap(getThreadToken());
+            m_heaps.push_back(heap);
+         }
+
+         t_last_id = m_id;
+         t_last_heap = heap;
+         return heap;
+      }
+
+   public:
+      ThreadLocalAllocator()
+         : m_id(__sync_add_and_fetch(&s_next_id, 1))
+      {}
+
+      virtual ~ThreadLocalAllocator()
+      {
+         UInt64 items = 0;
+         for(typename std::vector<Heap*>::iterator it = m_heaps.begin(); it != m_heaps.end(); ++it)
+         {
+            items += (*it)->getItems();
+            delete *it;
+         }
+         if (items)
+         {
+            int status;
+            char *nameoftype = abi::__cxa_demangle(typeid(T).name(), 0, 0, &status);
+            printf("[ALLOC] %" PRIu64 " items of type %s not freed\n", items, nameoftype);
+            free(nameoftype);
+         }
+      }
+
+      virtual void* alloc(size_t bytes)
+      {
+         return getHeap()->alloc(bytes);
+      }
+
+      virtual void _dealloc(void* ptr)
+      {
+         // Elements point to the Heap that allocated them, never to us
+         LOG_PRINT_ERROR("ThreadLocalAllocator::_dealloc should not be called");
+      }
+};
+
+template <typename T, unsigned MaxItems> UInt64 ThreadLocalAllocator<T, MaxItems>::s_next_id = 0;
+template <typename T, unsigned MaxItems> __thread UInt64 ThreadLocalAllocator<T, MaxItems>::t_last_id = 0;
+template <typename T, unsigned MaxItems> __thread typename ThreadLocalAllocator<T, MaxItems>::Heap *ThreadLocalAllocator<T, MaxItems>::t_last_heap = NULL;
+template <typename T, unsigned MaxItems> __thread char ThreadLocalAllocator<T, MaxItems>::t_thread_token;
+
 #endif // __ALLOCATOR_H
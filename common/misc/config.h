@@ -8,10 +8,6 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-// Enable to run core performance model in separate thread
-// When # simulated cores > # host cores, this is probably not very useful
-//#define ENABLE_PERF_MODEL_OWN_THREAD
-
 #include "fixed_types.h"
 #include "clock_skew_minimization_object.h"
 #include "cache_efficiency_tracker.h"
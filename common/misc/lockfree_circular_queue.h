@@ -0,0 +1,122 @@
+#ifndef LOCKFREE_CIRCULAR_QUEUE_H
+#define LOCKFREE_CIRCULAR_QUEUE_H
+
+#include "fixed_types.h"
+
+#include <assert.h>
+#include <sched.h>
+
+// Bounded circular queue that can be used without locking by exactly one producer and one consumer thread.
+// The producer owns m_first, the consumer owns m_last; each publishes its index with release semantics
+// only after it is done with the element, so the other side never sees a half-written or reused slot.
+// When used by a single thread it behaves like CircularQueue.
+template <class T> class LockFreeCircularQueue
+{
+   private:
+      const UInt32 m_size;
+      UInt32 m_first; // next element to be inserted here
+      UInt8 padding1[60];
+      UInt32 m_last;  // last element is here
+      UInt8 padding2[60];
+      T* const m_queue;
+
+      UInt32 loadFirst(void) const { return __atomic_load_n(&m_first, __ATOMIC_ACQUIRE); }
+      UInt32 loadLast(void) const { return __atomic_load_n(&m_last, __ATOMIC_ACQUIRE); }
+
+   public:
+      typedef T value_type;
+
+      LockFreeCircularQueue(UInt32 size = 63);
+      ~LockFreeCircularQueue();
+
+      // Producer side
+      void push(const T& t);
+      void push_wait(const T& t);
+      bool full(void) const;
+
+      // Consumer side
+      T& front(void);
+      T pop(void);
+
+      // Either side, the result may be stale by the time it is used
+      bool empty(void) const;
+      UInt32 size(void) const;
+};
+
+template <class T>
+LockFreeCircularQueue<T>::LockFreeCircularQueue(UInt32 size)
+   // Since we use head == tail as the empty condition instead of an extra empty flag, we can hold at most m_size-1 elements
+   : m_size(size + 1)
+   , m_first(0)
+   , m_last(0)
+   , m_queue(new T[m_size])
+{
+}
+
+template <class T>
+LockFreeCircularQueue<T>::~LockFreeCircularQueue()
+{
+   delete [] m_queue;
+}
+
+template <class T>
+void
+LockFreeCircularQueue<T>::push(const T& t)
+{
+   assert(!full());
+   m_queue[m_first] = t;
+   __atomic_store_n(&m_first, (m_first + 1) % m_size, __ATOMIC_RELEASE);
+}
+
+template <class T>
+void
+LockFreeCircularQueue<T>::push_wait(const T& t)
+{
+   // The consumer is expected to run on its own host core, so yield rather than block
+   while (full())
+      sched_yield();
+   push(t);
+}
+
+template <class T>
+T&
+LockFreeCircularQueue<T>::front(void)
+{
+   assert(!empty());
+   return m_queue[m_last];
+}
+
+template <class T>
+T
+LockFreeCircularQueue<T>::pop(void)
+{
+   assert(!empty());
+   // Read the element before handing its slot back to the producer
+   T t = m_queue[m_last];
+   __atomic_store_n(&m_last, (m_last + 1) % m_size, __ATOMIC_RELEASE);
+   return t;
+}
+
+template <class T>
+bool
+LockFreeCircularQueue<T>::full(void) const
+{
+   return (m_first + 1) % m_size == loadLast();
+}
+
+template <class T>
+bool
+LockFreeCircularQueue<T>::empty(void) const
+{
+   return loadFirst() == loadLast();
+}
+
+template <class T>
+UInt32
+LockFreeCircularQueue<T>::size(void) const
+{
+   UInt32 last = loadLast();
+   return (loadFirst() + m_size - last) % m_size;
+}
+
+#endif // LOCKFREE_CIRCULAR_QUEUE_H
@@ -3,6 +3,7 @@
 #include "hooks_manager.h"
 #include "utils.h"
 #include "itostr.h"
+#include "config.hpp"
 
 #include <math.h>
 #include <stdio.h>
@@ -31,6 +32,8 @@ const char* db_create_stmts[] = {
 const char db_insert_stmt_name[] = "INSERT INTO `names` (nameid, objectname, metricname) VALUES (?, ?, ?);";
 const char db_insert_stmt_prefix[] = "INSERT INTO `prefixes` (prefixid, prefixname) VALUES (?, ?);";
 const char db_insert_stmt_value[] = "INSERT INTO `values` (prefixid, nameid, core, value) VALUES (?, ?, ?, ?);";
+// Insert values in batches of this many rows per statement (4 parameters per row, older SQLite versions allow at most 999 parameters)
+const unsigned int db_insert_values_rows = 200;
 
 UInt64 getWallclockTimeCallback(String objectName, UInt32 index, String metricName, UInt64 arg)
 {
@@ -44,6 +47,11 @@ StatsManager::StatsManager()
    : m_keyid(0)
    , m_prefixnum(0)
    , m_db(NULL)
+   , m_flat_metrics_valid(false)
+   , m_async(Sim()->getCfg()->getBool("general/stats_async_write"))
+   , m_async_running(false)
+   , m_async_stop(false)
+   , m_async_thread(NULL)
 {
    init();
 
@@ -52,6 +60,18 @@ StatsManager::StatsManager()
 
 StatsManager::~StatsManager()
 {
+   if (m_async_running)
+   {
+      // Let the writer thread drain the queue and exit
+      {
+         ScopedLock sl(m_async_lock);
+         m_async_stop = true;
+         m_async_cond.signal();
+      }
+      m_async_thread->join();
+      delete m_async_thread;
+   }
+
    for(StatsObjectList::iterator it1 = m_objects.begin(); it1 != m_objects.end(); ++it1)
       for (StatsMetricList::iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
          for(StatsIndexList::iterator it3 = it2->second.second.begin(); it3 != it2->second.second.end(); ++it3)
@@ -62,6 +82,7 @@ StatsManager::~StatsManager()
       sqlite3_finalize(m_stmt_insert_name);
       sqlite3_finalize(m_stmt_insert_prefix);
       sqlite3_finalize(m_stmt_insert_value);
+      sqlite3_finalize(m_stmt_insert_values);
       sqlite3_close(m_db);
    }
 }
@@ -90,6 +111,12 @@ StatsManager::init()
    sqlite3_prepare(m_db, db_insert_stmt_prefix, -1, &m_stmt_insert_prefix, NULL);
    sqlite3_prepare(m_db, db_insert_stmt_value, -1, &m_stmt_insert_value, NULL);
 
+   String stmt_values = "INSERT INTO `values` (prefixid, nameid, core, value) VALUES (?, ?, ?, ?)";
+   for(unsigned int i = 1; i < db_insert_values_rows; ++i)
+      stmt_values += ", (?, ?, ?, ?)";
+   ret = sqlite3_prepare(m_db, stmt_values.c_str(), -1, &m_stmt_insert_values, NULL);
+   LOG_ASSERT_ERROR(ret == SQLITE_OK, "Error preparing SQL statement: %s", sqlite3_errmsg(m_db));
+
    sqlite3_exec(m_db, "BEGIN TRANSACTION", NULL, NULL, NULL);
    for(StatsObjectList::iterator it1 = m_objects.begin(); it1 != m_objects.end(); ++it1)
    {
@@ -116,6 +143,8 @@ StatsManager::busy_handler(int count)
 void
 StatsManager::recordMetricName(UInt64 keyId, std::string objectName, std::string metricName)
 {
+   ScopedLock sl(m_db_lock);
+
    int res;
    sqlite3_reset(m_stmt_insert_name);
    sqlite3_bind_int(m_stmt_insert_name, 1, keyId);
@@ -133,41 +162,138 @@ StatsManager::recordStats(String prefix)
    // Allow lazily-maintained statistics to be updated
    Sim()->getHooksManager()->callHooks(HookType::HOOK_PRE_STAT_WRITE, (UInt64)prefix.c_str());
 
+   Snapshot *snapshot = takeSnapshot(prefix);
+
+   if (m_async)
+   {
+      ScopedLock sl(m_async_lock);
+      if (!m_async_running)
+      {
+         m_async_running = true;
+         m_async_thread = _Thread::create(this);
+         m_async_thread->run();
+      }
+      m_async_queue.push_back(snapshot);
+      m_async_cond.signal();
+   }
+   else
+   {
+      writeSnapshot(snapshot);
+      delete snapshot;
+   }
+}
+
+void
+StatsManager::flushStats()
+{
+   ScopedLock sl(m_async_lock);
+   while (!m_async_queue.empty())
+      m_async_done_cond.wait(m_async_lock);
+}
+
+StatsManager::Snapshot *
+StatsManager::takeSnapshot(String prefix)
+{
+   if (!m_flat_metrics_valid)
+   {
+      m_flat_metrics.clear();
+      for(StatsObjectList::iterator it1 = m_objects.begin(); it1 != m_objects.end(); ++it1)
+         for (StatsMetricList::iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
+            for(StatsIndexList::iterator it3 = it2->second.second.begin(); it3 != it2->second.second.end(); ++it3)
+            {
+               FlatMetric flat = { it3->second, it2->second.first };
+               m_flat_metrics.push_back(flat);
+            }
+      m_flat_metrics_valid = true;
+   }
+
+   Snapshot *snapshot = new Snapshot();
+   snapshot->prefixid = ++m_prefixnum;
+   snapshot->prefix = prefix;
+   snapshot->values.reserve(m_flat_metrics.size());
+   for(std::vector<FlatMetric>::iterator it = m_flat_metrics.begin(); it != m_flat_metrics.end(); ++it)
+   {
+      if (!it->metric->isDefault())
+      {
+         SnapshotValue value = { UInt32(it->nameid), it->metric->index, it->metric->recordMetric() };
+         snapshot->values.push_back(value);
+      }
+   }
+   return snapshot;
+}
+
+void
+StatsManager::writeSnapshot(Snapshot *snapshot)
+{
+   ScopedLock sl(m_db_lock);
+
    int res;
-   int prefixid = ++m_prefixnum;
 
    res = sqlite3_exec(m_db, "BEGIN TRANSACTION", NULL, NULL, NULL);
    LOG_ASSERT_ERROR(res == SQLITE_OK, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
 
    sqlite3_reset(m_stmt_insert_prefix);
-   sqlite3_bind_int(m_stmt_insert_prefix, 1, prefixid);
-   sqlite3_bind_text(m_stmt_insert_prefix, 2, prefix.c_str(), -1, SQLITE_TRANSIENT);
+   sqlite3_bind_int(m_stmt_insert_prefix, 1, snapshot->prefixid);
+   sqlite3_bind_text(m_stmt_insert_prefix, 2, snapshot->prefix.c_str(), -1, SQLITE_TRANSIENT);
    res = sqlite3_step(m_stmt_insert_prefix);
    LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
 
-   for(StatsObjectList::iterator it1 = m_objects.begin(); it1 != m_objects.end(); ++it1)
+   const std::vector<SnapshotValue> &values = snapshot->values;
+   size_t i = 0;
+   // Full batches use the multi-row statement, the remainder is inserted one row at a time
+   for( ; i + db_insert_values_rows <= values.size(); i += db_insert_values_rows)
    {
-      for (StatsMetricList::iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
+      sqlite3_reset(m_stmt_insert_values);
+      for(unsigned int j = 0; j < db_insert_values_rows; ++j)
       {
-         for(StatsIndexList::iterator it3 = it2->second.second.begin(); it3 != it2->second.second.end(); ++it3)
-         {
-            if (!it3->second->isDefault())
-            {
-               sqlite3_reset(m_stmt_insert_value);
-               sqlite3_bind_int(m_stmt_insert_value, 1, prefixid);
-               sqlite3_bind_int(m_stmt_insert_value, 2, it2->second.first);   // Metric ID
-               sqlite3_bind_int(m_stmt_insert_value, 3, it3->second->index);  // Core ID
-               sqlite3_bind_int64(m_stmt_insert_value, 4, it3->second->recordMetric());
-               res = sqlite3_step(m_stmt_insert_value);
-               LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
-            }
-         }
+         sqlite3_bind_int(m_stmt_insert_values, 4*j + 1, snapshot->prefixid);
+         sqlite3_bind_int(m_stmt_insert_values, 4*j + 2, values[i + j].nameid);   // Metric ID
+         sqlite3_bind_int(m_stmt_insert_values, 4*j + 3, values[i + j].index);    // Core ID
+         sqlite3_bind_int64(m_stmt_insert_values, 4*j + 4, values[i + j].value);
       }
+      res = sqlite3_step(m_stmt_insert_values);
+      LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
    }
+   for( ; i < values.size(); ++i)
+   {
+      sqlite3_reset(m_stmt_insert_value);
+      sqlite3_bind_int(m_stmt_insert_value, 1, snapshot->prefixid);
+      sqlite3_bind_int(m_stmt_insert_value, 2, values[i].nameid);   // Metric ID
+      sqlite3_bind_int(m_stmt_insert_value, 3, values[i].index);    // Core ID
+      sqlite3_bind_int64(m_stmt_insert_value, 4, values[i].value);
+      res = sqlite3_step(m_stmt_insert_value);
+      LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
+   }
+
    res = sqlite3_exec(m_db, "END TRANSACTION", NULL, NULL, NULL);
    LOG_ASSERT_ERROR(res == SQLITE_OK, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
 }
 
+void
+StatsManager::run()
+{
+   ScopedLock sl(m_async_lock);
+   while (true)
+   {
+      while (m_async_queue.empty() && !m_async_stop)
+         m_async_cond.wait(m_async_lock);
+      if (m_async_queue.empty())
+         break;
+
+      // Write without holding the queue lock, so the simulation can keep queueing snapshots
+      Snapshot *snapshot = m_async_queue.front();
+      m_async_lock.release();
+      writeSnapshot(snapshot);
+      delete snapshot;
+      m_async_lock.acquire();
+
+      m_async_queue.pop_front();
+      m_async_done_cond.broadcast();
+   }
+   m_async_running = false;
+   m_async_done_cond.broadcast();
+}
+
 void
 StatsManager::registerMetric(StatsMetricBase *metric)
 {
@@ -176,6 +302,7 @@ StatsManager::registerMetric(StatsMetricBase *metric)
    LOG_ASSERT_ERROR(m_objects[_objectName][_metricName].second.count(metric->index) == 0,
       "Duplicate statistic %s.%s[%d]", _objectName.c_str(), _metricName.c_str(), metric->index);
    m_objects[_objectName][_metricName].second[metric->index] = metric;
+   m_flat_metrics_valid = false;
 
    if (m_objects[_objectName][_metricName].first == 0)
    {
@@ -204,6 +331,8 @@ StatsManager::getMetricObject(String objectName, UInt32 index, String metricName
 void
 StatsManager::logTopology(String component, core_id_t core_id, core_id_t master_id)
 {
+   ScopedLock sl(m_db_lock);
+
    sqlite3_stmt *stmt;
    sqlite3_prepare(m_db, "INSERT INTO topology (componentname, coreid, masterid) VALUES (?, ?, ?);", -1, &stmt, NULL);
    sqlite3_bind_text(stmt, 1, component.c_str(), -1, SQLITE_TRANSIENT);
@@ -220,6 +349,8 @@ StatsManager::logEvent(event_type_t event, SubsecondTime time, core_id_t core_id
    if (time == SubsecondTime::MaxTime())
       time = Sim()->getClockSkewMinimizationServer()->getGlobalTime();
 
+   ScopedLock sl(m_db_lock);
+
    sqlite3_stmt *stmt;
    sqlite3_prepare(m_db, "INSERT INTO event (event, time, core, thread, value0, value1, description) VALUES (?, ?, ?, ?, ?, ?, ?);", -1, &stmt, NULL);
    sqlite3_bind_int(stmt, 1, event);
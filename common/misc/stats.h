@@ -2,8 +2,13 @@
 
 #include "simulator.h"
 #include "itostr.h"
+#include "lock.h"
+#include "cond.h"
+#include "_thread.h"
 
 #include <cstring>
+#include <deque>
+#include <vector>
 #include <sqlite3.h>
 
 class StatsMetricBase
@@ -55,7 +60,7 @@ class StatsMetricCallback : public StatsMetricBase
 };
 
 
-class StatsManager
+class StatsManager : public Runnable
 {
    public:
       // Event type                 core              thread            arg0           arg1              description
@@ -72,6 +77,8 @@ class StatsManager
       ~StatsManager();
       void init();
       void recordStats(String prefix);
+      // Wait until all snapshots taken by recordStats() are in the database (asynchronous mode only)
+      void flushStats();
       void registerMetric(StatsMetricBase *metric);
       StatsMetricBase *getMetricObject(String objectName, UInt32 index, String metricName);
       void logTopology(String component, core_id_t core_id, core_id_t master_id);
@@ -87,6 +94,8 @@ class StatsManager
       sqlite3_stmt *m_stmt_insert_name;
       sqlite3_stmt *m_stmt_insert_prefix;
       sqlite3_stmt *m_stmt_insert_value;
+      sqlite3_stmt *m_stmt_insert_values;   // Multi-row version of m_stmt_insert_value
+      Lock m_db_lock;
 
       // Use std::string here because String (__versa_string) does not provide a hash function for STL containers with gcc < 4.6
       typedef std::unordered_map<UInt64, StatsMetricBase *> StatsIndexList;
@@ -95,6 +104,44 @@ class StatsManager
       typedef std::unordered_map<std::string, StatsMetricList> StatsObjectList;
       StatsObjectList m_objects;
 
+      // Flattened copy of m_objects, so taking a snapshot does not need to walk the nested maps.
+      // Rebuilt on the next snapshot after a metric was registered.
+      struct FlatMetric
+      {
+         StatsMetricBase *metric;
+         UInt64 nameid;
+      };
+      std::vector<FlatMetric> m_flat_metrics;
+      bool m_flat_metrics_valid;
+
+      // A snapshot holds the values of all non-default metrics at the time of recordStats()
+      struct SnapshotValue
+      {
+         UInt32 nameid;
+         UInt32 index;
+         UInt64 value;
+      };
+      struct Snapshot
+      {
+         int prefixid;
+         String prefix;
+         std::vector<SnapshotValue> values;
+      };
+
+      // Asynchronous mode: recordStats() only takes the snapshot, a background thread writes it to the database
+      bool m_async;
+      bool m_async_running;
+      bool m_async_stop;
+      _Thread *m_async_thread;
+      std::deque<Snapshot*> m_async_queue;
+      Lock m_async_lock;
+      ConditionVariable m_async_cond;        // Signaled when a snapshot is queued, or the thread should stop
+      ConditionVariable m_async_done_cond;   // Signaled when a snapshot was written, or the thread stopped
+
+      void run();
+      Snapshot *takeSnapshot(String prefix);
+      void writeSnapshot(Snapshot *snapshot);
+
       static int __busy_handler(void* self, int count) { return ((StatsManager*)self)->busy_handler(count); }
       int busy_handler(int count);
 
@@ -19,6 +19,7 @@
 
 Network::Network(Core *core)
       : _core(core)
+      , _numRemotePackets(0)
 {
    LOG_ASSERT_ERROR(sizeof(g_type_to_static_network_map) / sizeof(EStaticNetwork) == NUM_PACKET_TYPES,
                     "Static network type map has incorrect number of entries.");
@@ -95,8 +96,7 @@ void Network::netPullFromTransport()
          // if this isn't a broadcast message, then we shouldn't process it further
          if (packet.receiver != NetPacket::BROADCAST)
          {
-            if (packet.length > 0)
-               delete [] (Byte*) packet.data;
+            packet.release();
             continue;
          }
       }
@@ -119,8 +119,7 @@ void Network::netPullFromTransport()
          assert(0 <= packet.type && packet.type < NUM_PACKET_TYPES);
 
          callback(_callbackObjs[packet.type], packet);
-         if (packet.length > 0)
-            delete [] (Byte*) packet.data;
+         packet.release();
       }
 
       // synchronous I/O support
@@ -157,6 +156,8 @@ SInt32 Network::netSend(NetPacket& packet)
    NetworkModel *model = _models[g_type_to_static_network_map[packet.type]];
 
    model->countPacket(packet);
+   if (packet.receiver != packet.sender)
+      __sync_fetch_and_add(&_numRemotePackets, 1);
 
    std::vector<NetworkModel::Hop> hopVec;
    model->routePacket(packet, hopVec);
@@ -164,6 +165,9 @@ SInt32 Network::netSend(NetPacket& packet)
    Byte *buffer = packet.makeBuffer();
    SubsecondTime start_time = packet.time;
 
+   if (hopVec.empty())
+      Transport::freeBuffer(buffer);
+
    for (UInt32 i = 0; i < hopVec.size(); i++)
    {
 	   /*
@@ -196,7 +200,15 @@ SInt32 Network::netSend(NetPacket& packet)
          }
       }
 
-      NetPacket* buff_pkt = (NetPacket*) buffer;
+      // The transport takes ownership of the buffer, so all but the last hop get a copy
+      Byte *hop_buffer = buffer;
+      if (i + 1 < hopVec.size())
+      {
+         hop_buffer = Transport::allocBuffer(packet.bufferSize());
+         memcpy(hop_buffer, buffer, packet.bufferSize());
+      }
+
+      NetPacket* buff_pkt = (NetPacket*) hop_buffer;
 
       if (_core->getId() == buff_pkt->sender)
          buff_pkt->start_time = start_time;
@@ -204,13 +216,11 @@ SInt32 Network::netSend(NetPacket& packet)
       buff_pkt->time = hopVec[i].time;
       buff_pkt->receiver = hopVec[i].final_dest;
 
-      _transport->send(hopVec[i].next_dest, buffer, packet.bufferSize());
+      _transport->sendBuffer(hopVec[i].next_dest, hop_buffer);
 
       LOG_PRINT("Sent packet");
    }
 
-   delete [] buffer;
-
    return packet.length;
 }
 
@@ -521,14 +531,18 @@ NetPacket::NetPacket(Byte *buffer)
    memcpy(this, buffer, sizeof(*this));
 
    // LOG_ASSERT_ERROR(length > 0, "type(%u), sender(%i), receiver(%i), length(%u)", type, sender, receiver, length);
+   // Leave the payload where it is, release() frees the buffer once the receiver is done with it
    if (length > 0)
-   {
-      Byte* data_buffer = new Byte[length];
-      memcpy(data_buffer, buffer + sizeof(*this), length);
-      data = data_buffer;
-   }
+      data = buffer + sizeof(*this);
+   else
+      Transport::freeBuffer(buffer);
+}
 
-   delete [] buffer;
+void NetPacket::release()
+{
+   if (length > 0)
+      Transport::freeBuffer((Byte*)data - sizeof(*this));
+   data = NULL;
 }
 
 // This implementation is slightly wasteful because there is no need
@@ -544,7 +558,7 @@ Byte* NetPacket::makeBuffer() const
    UInt32 size = bufferSize();
    assert(size >= sizeof(NetPacket));
 
-   Byte *buffer = new Byte[size];
+   Byte *buffer = Transport::allocBuffer(size);
 
    memcpy(buffer, this, sizeof(*this));
    memcpy(buffer + sizeof(*this), data, length);
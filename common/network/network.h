@@ -33,12 +33,14 @@ public:
    const void *data;
 
    NetPacket();
+   // Takes ownership of a transport buffer, data points into it until release() is called
    explicit NetPacket(Byte*);
    NetPacket(SubsecondTime time, PacketType type, SInt32 sender,
              SInt32 receiver, UInt32 length, const void *data);
 
    UInt32 bufferSize() const;
    Byte *makeBuffer() const;
+   void release();
 
    static const SInt32 BROADCAST = 0xDEADBABE;
 };
@@ -70,6 +72,7 @@ class Network
       Core *getCore() const { return _core; }
       Transport::Node *getTransport() const { return _transport; }
 
+      // The packet's data is only valid during the callback, copy anything that is needed afterwards
       typedef void (*NetworkCallback)(void*, NetPacket);
 
       void registerCallback(PacketType type,
@@ -83,6 +86,7 @@ class Network
       // -- Main interface -- //
 
       SInt32 netSend(NetPacket& packet);
+      // Call release() on the returned packet when done with its data
       NetPacket netRecv(const NetMatch &match, UInt64 timeout_ns = 0);
 
       // -- Wrappers -- //
@@ -102,6 +106,9 @@ class Network
       // Modeling
       UInt32 getModeledLength(const NetPacket& pkt);
 
+      // Number of packets sent from this node to other nodes, used to adapt the barrier quantum
+      UInt64 getNumRemotePackets() const { return _numRemotePackets; }
+
    private:
       NetworkModel * _models[NUM_STATIC_NETWORKS];
 
@@ -113,6 +120,7 @@ class Network
 
       SInt32 _tid;
       SInt32 _numMod;
+      UInt64 _numRemotePackets;
 
       NetQueue _netQueue;
       Lock _netQueueLock;
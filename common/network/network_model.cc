@@ -7,6 +7,7 @@
 #include "network_model_emesh_hop_counter.h"
 #include "network_model_emesh_hop_by_hop.h"
 #include "network_model_bus.h"
+#include "network_model_hmc_link.h"
 #include "stats.h"
 #include "log.h"
 #include "config.hpp"
@@ -58,6 +59,9 @@ NetworkModel::createModel(Network *net, UInt32 model_type, EStaticNetwork net_ty
    case NETWORK_BUS:
       return new NetworkModelBus(net, net_type);
 
+   case NETWORK_HMC_LINK:
+      return new NetworkModelHmcLink(net, net_type);
+
    default:
       assert(false);
       return NULL;
@@ -75,6 +79,8 @@ NetworkModel::parseNetworkType(String str)
       return NETWORK_EMESH_HOP_BY_HOP;
    else if (str == "bus")
       return NETWORK_BUS;
+   else if (str == "hmc_link")
+      return NETWORK_HMC_LINK;
    else
       return (UInt32)-1;
 }
@@ -87,6 +93,7 @@ NetworkModel::computeCoreCountConstraints(UInt32 network_type, SInt32 core_count
       case NETWORK_MAGIC:
       case NETWORK_EMESH_HOP_COUNTER:
       case NETWORK_BUS:
+      case NETWORK_HMC_LINK:
          return std::make_pair(false,core_count);
 
       case NETWORK_EMESH_HOP_BY_HOP:
@@ -106,6 +113,7 @@ NetworkModel::computeMemoryControllerPositions(UInt32 network_type, SInt32 num_m
       case NETWORK_MAGIC:
       case NETWORK_EMESH_HOP_COUNTER:
       case NETWORK_BUS:
+      case NETWORK_HMC_LINK:
          {
             SInt32 spacing_between_memory_controllers = core_count / num_memory_controllers;
             std::vector<core_id_t> core_list_with_memory_controllers;
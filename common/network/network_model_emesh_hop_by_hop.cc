@@ -9,6 +9,7 @@
 #include "dvfs_manager.h"
 #include "stats.h"
 #include "config.hpp"
+#include "timer.h"
 
 #include <math.h>
 #include <stdlib.h>
@@ -29,10 +30,13 @@ const char* OutputDirectionString(NetworkModelEMeshHopByHop::OutputDirection dir
 NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwork net_type):
    NetworkModel(net, net_type),
    m_enabled(false),
+   m_model_hmc(false),
    m_total_bytes_sent(0),
    m_total_packets_sent(0),
    m_total_bytes_received(0),
    m_total_packets_received(0),
+   m_total_external_link_packets(0),
+   m_total_external_link_bytes(0),
    m_total_contention_delay(SubsecondTime::Zero()),
    m_total_packet_latency(SubsecondTime::Zero()),
    m_fake_node(false),
@@ -42,6 +46,9 @@ NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwor
    m_hmc_ext_link_bw(0),
    m_hop_latency(Sim()->getDvfsManager()->getCoreDomain(m_core_id), 0)
 {
+   for (UInt32 i = 0; i < NUM_LOCKS; i++)
+      m_lock_wait[i] = 0;
+
      	// Get the Link Bandwidth, Hop Latency and if it has broadcast tree mechanism
    try
    {
@@ -80,6 +87,12 @@ NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, EStaticNetwor
    registerStatsMetric(name, m_core_id, "packets-in", &m_total_packets_received);
    registerStatsMetric(name, m_core_id, "contention-delay", &m_total_contention_delay);
    registerStatsMetric(name, m_core_id, "total-delay", &m_total_packet_latency);
+   Sim()->getStatsManager()->registerMetric(new StatsMetricCallback(name, m_core_id, "lock-wait-cycles", getLockWaitCallback, (UInt64)this));
+   if (m_model_hmc)
+   {
+      registerStatsMetric(name, m_core_id, "external-link-packets", &m_total_external_link_packets);
+      registerStatsMetric(name, m_core_id, "external-link-bytes", &m_total_external_link_bytes);
+   }
 
    computeMeshDimensions(m_mesh_width, m_mesh_height);
 
@@ -110,7 +123,8 @@ NetworkModelEMeshHopByHop::~NetworkModelEMeshHopByHop()
 // this function partition a grid of nodes according to HMC specification
 void 
 NetworkModelEMeshHopByHop::calculateEdgeVaults(){
-	if(Sim()->getCfg()->getBool("network/emesh_hop_by_hop/HMC_topology/model_hmc")){ //model HMC
+	m_model_hmc = Sim()->getCfg()->getBool("network/emesh_hop_by_hop/HMC_topology/model_hmc");
+	if(m_model_hmc){ //model HMC
 		String size = Sim()->getCfg()->getString("network/emesh_hop_by_hop/size");
 	    LOG_ASSERT_ERROR(size!="", "For modeling HMC-style network, please specify network/emesh_hop_by_hop/size: WIDTH:HEIGHT"); 
 
@@ -258,6 +272,12 @@ NetworkModelEMeshHopByHop::calculateEdgeVaults(){
 	    	} /* end grid quadrant 8 */
 	    } /* end grid */
 	} 
+
+	// Resolve this node's edge roles once, so the per-hop path does not need to search the lists
+	m_hmc_external_link[UP] = std::find(m_list_up.begin(), m_list_up.end(), m_core_id) != m_list_up.end();
+	m_hmc_external_link[DOWN] = std::find(m_list_down.begin(), m_list_down.end(), m_core_id) != m_list_down.end();
+	m_hmc_external_link[LEFT] = std::find(m_list_left.begin(), m_list_left.end(), m_core_id) != m_list_left.end();
+	m_hmc_external_link[RIGHT] = std::find(m_list_right.begin(), m_list_right.end(), m_core_id) != m_list_right.end();
 }
 
 void
@@ -268,10 +288,10 @@ NetworkModelEMeshHopByHop::createQueueModels(String name)
     m_injection_port_queue_model = QueueModel::create(name+".link-in", m_core_id, m_queue_model_type, min_processing_time);
     m_ejection_port_queue_model = QueueModel::create(name+".link-out", m_core_id, m_queue_model_type, min_processing_time);
  		
-	bool right = std::find(m_list_right.begin(), m_list_right.end(), m_core_id) != m_list_right.end();
-	bool left = std::find(m_list_left.begin(), m_list_left.end(), m_core_id) != m_list_left.end();
-	bool up = std::find(m_list_up.begin(), m_list_up.end(), m_core_id) != m_list_up.end();
-	bool down = std::find(m_list_down.begin(), m_list_down.end(), m_core_id) != m_list_down.end();
+	bool right = m_hmc_external_link[RIGHT];
+	bool left = m_hmc_external_link[LEFT];
+	bool up = m_hmc_external_link[UP];
+	bool down = m_hmc_external_link[DOWN];
 	if(!right && !left && !up && !down){
 	    cout << "[LINGXI]: in emesh_hop_by_hop. m_core_id: " << to_string(m_core_id) << " all unmodified queues" << endl;
 	    m_queue_models[DOWN] = QueueModel::create(name+".link-down", m_core_id, m_queue_model_type, min_processing_time);
@@ -317,8 +337,8 @@ NetworkModelEMeshHopByHop::createQueueModels(String name)
 void
 NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, std::vector<Hop> &nextHops)
 {
-   ScopedLock sl(m_lock);
-
+   // No node-wide lock here: routing itself only reads configuration,
+   // the queue models and counters are protected by their own locks (see computeQueueDelay)
    core_id_t requester = INVALID_CORE_ID;
 
    if (pkt.type == SHARED_MEM_1)
@@ -335,8 +355,8 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, std::vector<Hop> &n
 
    if (pkt.sender == m_core_id)
    {
-      m_total_packets_sent ++;
-      m_total_bytes_sent += pkt_length;
+      __sync_fetch_and_add(&m_total_packets_sent, 1);
+      __sync_fetch_and_add(&m_total_bytes_sent, pkt_length);
    }
 
    if (pkt.receiver == NetPacket::BROADCAST)
@@ -428,8 +448,6 @@ NetworkModelEMeshHopByHop::processReceivedPacket(NetPacket& pkt)
 {
 //	if(pkt.receiver >= 7 || m_core_id >= 7)
 //		cout << "receiver: " << to_string(pkt.receiver) << " m_core_id: " << m_core_id << endl;
-   ScopedLock sl(m_lock);
-
    UInt32 pkt_length = getNetwork()->getModeledLength(pkt);
 
    core_id_t requester = INVALID_CORE_ID;
@@ -460,6 +478,10 @@ NetworkModelEMeshHopByHop::processReceivedPacket(NetPacket& pkt)
       pkt.queue_delay += ejection_port_queue_delay;
    }
 
+   UInt64 t_start = rdtsc();
+   ScopedLock sl(m_locks[STATS_LOCK]);
+   m_lock_wait[STATS_LOCK] += rdtsc() - t_start;
+
    m_total_packets_received ++;
    m_total_bytes_received += pkt_length;
    m_total_packet_latency += packet_latency;
@@ -531,24 +553,14 @@ NetworkModelEMeshHopByHop::computeLatency(OutputDirection direction, SubsecondTi
    //cout << "################## stock processing_time: " << to_string(processing_time.getFS()) << endl;
    if (m_queue_model_enabled)
    {
-   		UInt32 num_bits = pkt_length * 8;
-   		if(Sim()->getCfg()->getBool("network/emesh_hop_by_hop/HMC_topology/model_hmc")){ // [LINGXI]: modeling HMC
-   			// replace stock processing_time with the customized ones
-			if((direction == UP && std::find(m_list_up.begin(), m_list_up.end(), m_core_id) != m_list_up.end()) 
-				|| (direction == DOWN && std::find(m_list_down.begin(), m_list_down.end(), m_core_id) != m_list_down.end())
-				|| (direction == RIGHT && std::find(m_list_right.begin(), m_list_right.end(), m_core_id) != m_list_right.end())
-				|| (direction == LEFT && std::find(m_list_left.begin(), m_list_left.end(), m_core_id) != m_list_left.end())){
-
-				cout << "[LINGXI]: in emesh_hop_by_hop. Stock processing_time: " << to_string(processing_time.getFS()) << endl;
-				processing_time = m_hmc_ext_link_bw.getRoundedLatency(num_bits);
-				cout << "core_id: " << to_string(m_core_id) 
-				<< " direction (UP==0, DOWN==1, LEFT==2, RIGHT==3: " << to_string(direction) 
-				<< " replaced stock processing_time with a custom time: " 
-				<< to_string(processing_time.getFS()) << endl;
-			} 	
+   		if(m_model_hmc && m_hmc_external_link[direction]){ // [LINGXI]: modeling HMC
+   			// replace stock processing_time with the external (cube-to-cube) link bandwidth
+			processing_time = m_hmc_ext_link_bw.getRoundedLatency(pkt_length * 8);
+			__sync_fetch_and_add(&m_total_external_link_packets, 1);
+			__sync_fetch_and_add(&m_total_external_link_bytes, pkt_length);
    		} 
 
-   		queue_delay = m_queue_models[direction]->computeQueueDelay(pkt_time, processing_time);
+   		queue_delay = computeQueueDelay(m_queue_models[direction], direction, pkt_time, processing_time);
     	if (queue_delay_stats)
         	*queue_delay_stats += queue_delay;
    }
@@ -572,7 +584,7 @@ NetworkModelEMeshHopByHop::computeInjectionPortQueueDelay(core_id_t pkt_receiver
 
    SubsecondTime processing_time = computeProcessingTime(pkt_length);
 
-   return m_injection_port_queue_model->computeQueueDelay(pkt_time, processing_time);
+   return computeQueueDelay(m_injection_port_queue_model, INJECTION_PORT, pkt_time, processing_time);
 }
 
 SubsecondTime
@@ -584,7 +596,28 @@ NetworkModelEMeshHopByHop::computeEjectionPortQueueDelay(SubsecondTime pkt_time,
       return SubsecondTime::Zero();
 
    SubsecondTime processing_time = computeProcessingTime(pkt_length);
-   return m_ejection_port_queue_model->computeQueueDelay(pkt_time, processing_time);
+   return computeQueueDelay(m_ejection_port_queue_model, EJECTION_PORT, pkt_time, processing_time);
+}
+
+SubsecondTime
+NetworkModelEMeshHopByHop::computeQueueDelay(QueueModel *queue_model, UInt32 lock_index, SubsecondTime pkt_time, SubsecondTime processing_time)
+{
+   // Use the raw TSC: Timer serializes with cpuid, which costs more than most uncontended acquires
+   UInt64 t_start = rdtsc();
+   ScopedLock sl(m_locks[lock_index]);
+   m_lock_wait[lock_index] += rdtsc() - t_start;
+
+   return queue_model->computeQueueDelay(pkt_time, processing_time);
+}
+
+UInt64
+NetworkModelEMeshHopByHop::getLockWaitCallback(String objectName, UInt32 index, String metricName, UInt64 arg)
+{
+   NetworkModelEMeshHopByHop *model = (NetworkModelEMeshHopByHop *)arg;
+   UInt64 lock_wait = 0;
+   for (UInt32 i = 0; i < NUM_LOCKS; i++)
+      lock_wait += model->m_lock_wait[i];
+   return lock_wait;
 }
 
 SubsecondTime
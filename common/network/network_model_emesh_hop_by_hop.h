@@ -41,15 +41,24 @@ class NetworkModelEMeshHopByHop : public NetworkModel
       list<int> m_list_left;
       list<int> m_list_up;
       list<int> m_list_down;
+      // Cached HMC configuration: m_hmc_external_link[direction] is true when that output link of this node leaves the cube
+      bool m_model_hmc;
+      bool m_hmc_external_link[NUM_OUTPUT_DIRECTIONS];
 
-      // Lock
-      Lock m_lock;
+      // Locks: each queue model has its own lock, so packets using different links or ports of this node
+      // are routed in parallel. m_lock_wait[] accumulates the host (TSC) cycles spent waiting on each lock,
+      // it is only updated while holding the corresponding lock.
+      enum { INJECTION_PORT = NUM_OUTPUT_DIRECTIONS, EJECTION_PORT, STATS_LOCK, NUM_LOCKS };
+      Lock m_locks[NUM_LOCKS];
+      UInt64 m_lock_wait[NUM_LOCKS];
 
       // Counters
       UInt64 m_total_bytes_sent;
       UInt64 m_total_packets_sent;
       UInt64 m_total_bytes_received;
       UInt64 m_total_packets_received;
+      UInt64 m_total_external_link_packets;
+      UInt64 m_total_external_link_bytes;
       SubsecondTime m_total_contention_delay;
       SubsecondTime m_total_packet_latency;
 
@@ -62,6 +71,8 @@ class NetworkModelEMeshHopByHop : public NetworkModel
       void addHop(OutputDirection direction, core_id_t final_dest, core_id_t next_dest, SubsecondTime pkt_time, UInt32 pkt_length, std::vector<Hop>& nextHops, core_id_t requester, subsecond_time_t *queue_delay_stats = NULL);
       SubsecondTime computeLatency(OutputDirection direction, SubsecondTime pkt_time, UInt32 pkt_length, core_id_t requester, subsecond_time_t *queue_delay_stats);
       SubsecondTime computeProcessingTime(UInt32 pkt_length);
+      SubsecondTime computeQueueDelay(QueueModel *queue_model, UInt32 lock_index, SubsecondTime pkt_time, SubsecondTime processing_time);
+      static UInt64 getLockWaitCallback(String objectName, UInt32 index, String metricName, UInt64 arg);
       core_id_t getNextDest(core_id_t final_dest, OutputDirection& direction);
 
       // Injection & Ejection Port Queue Models
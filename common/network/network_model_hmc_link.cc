@@ -0,0 +1,287 @@
+#include "core_manager.h"
+#include "simulator.h"
+#include "network.h"
+#include "network_model_hmc_link.h"
+#include "memory_manager_base.h"
+#include "stats.h"
+#include "log.h"
+#include "config.hpp"
+
+#include <algorithm>
+
+NetworkModelHmcLinkGlobal* NetworkModelHmcLink::_hmc_global[NUM_STATIC_NETWORKS] = { NULL };
+
+NetworkModelHmcLinkGlobal::Link::Link(String name, UInt32 id, String model_type, SubsecondTime min_processing_time)
+   : _flits_in_flight(0)
+   , _num_packets(0)
+   , _num_flits(0)
+   , _time_used(SubsecondTime::Zero())
+   , _total_queue_delay(SubsecondTime::Zero())
+   , _total_credit_delay(SubsecondTime::Zero())
+{
+   _queue_model = QueueModel::create(name + "-queue", id, model_type, min_processing_time);
+   registerStatsMetric(name, id, "num-packets", &_num_packets);
+   registerStatsMetric(name, id, "num-flits", &_num_flits);
+   registerStatsMetric(name, id, "time-used", &_time_used);
+   registerStatsMetric(name, id, "total-queue-delay", &_total_queue_delay);
+   registerStatsMetric(name, id, "total-credit-delay", &_total_credit_delay);
+}
+
+NetworkModelHmcLinkGlobal::Link::~Link()
+{
+   delete _queue_model;
+}
+
+NetworkModelHmcLinkGlobal::NetworkModelHmcLinkGlobal(String name)
+   : _cores_per_cube(Sim()->getCfg()->getInt("network/hmc_link/cores_per_cube"))
+   , _num_cubes((Config::getSingleton()->getApplicationCores() + _cores_per_cube - 1) / _cores_per_cube)
+   , _grid_width(1)
+   , _flit_size(Sim()->getCfg()->getInt("network/hmc_link/flit_size"))
+   , _link_credits(Sim()->getCfg()->getInt("network/hmc_link/link_credits"))
+   , _link_bandwidth(8 * Sim()->getCfg()->getFloat("network/hmc_link/link_bandwidth")) /* = 8 * GB/s = bits / ns */
+   , _link_latency(SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("network/hmc_link/link_latency"))))
+   , _intra_cube_latency(SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("network/hmc_link/intra_cube_latency"))))
+   , _links(_num_cubes * _num_cubes, NULL)
+{
+   String topology = Sim()->getCfg()->getString("network/hmc_link/topology");
+   if (topology == "daisy_chain")
+      _topology = DAISY_CHAIN;
+   else if (topology == "star")
+      _topology = STAR;
+   else if (topology == "grid")
+   {
+      _topology = GRID;
+      _grid_width = Sim()->getCfg()->getInt("network/hmc_link/grid_width");
+      LOG_ASSERT_ERROR(_grid_width > 0 && _num_cubes % _grid_width == 0,
+         "network/hmc_link/grid_width (%u) must divide the number of cubes (%u)", _grid_width, _num_cubes);
+   }
+   else
+      LOG_PRINT_ERROR("Invalid network/hmc_link/topology %s", topology.c_str());
+
+   LOG_ASSERT_ERROR(_cores_per_cube > 0, "network/hmc_link/cores_per_cube must be > 0");
+   LOG_ASSERT_ERROR(_flit_size > 0, "network/hmc_link/flit_size must be > 0");
+
+   String model_type = Sim()->getCfg()->getString("network/hmc_link/queue_model/type");
+   SubsecondTime min_processing_time = _link_bandwidth.getRoundedLatency(8 * _flit_size);
+
+   // Create both directions of every cube-to-cube connection
+   for(UInt32 src = 0; src < _num_cubes; ++src)
+   {
+      for(UInt32 dst = 0; dst < _num_cubes; ++dst)
+      {
+         bool connected = false;
+         switch(_topology)
+         {
+            case DAISY_CHAIN:
+               connected = (src + 1 == dst) || (dst + 1 == src);
+               break;
+            case STAR:
+               connected = (src != dst) && (src == 0 || dst == 0);
+               break;
+            case GRID:
+               connected = (src / _grid_width == dst / _grid_width && (src + 1 == dst || dst + 1 == src))
+                        || (src + _grid_width == dst) || (dst + _grid_width == src);
+               break;
+         }
+         if (connected)
+            _links[src * _num_cubes + dst] = new Link(name + ".link", src * _num_cubes + dst, model_type, min_processing_time);
+      }
+   }
+}
+
+NetworkModelHmcLinkGlobal::~NetworkModelHmcLinkGlobal()
+{
+   for(std::vector<Link*>::iterator it = _links.begin(); it != _links.end(); ++it)
+      if (*it)
+         delete *it;
+}
+
+UInt32
+NetworkModelHmcLinkGlobal::getNextCube(UInt32 cube, UInt32 dst_cube) const
+{
+   switch(_topology)
+   {
+      case DAISY_CHAIN:
+         return cube < dst_cube ? cube + 1 : cube - 1;
+      case STAR:
+         return cube == 0 ? dst_cube : 0;
+      case GRID:
+      {
+         // Dimension-order routing: first along the row, then along the column
+         UInt32 x = cube % _grid_width, dst_x = dst_cube % _grid_width;
+         if (x != dst_x)
+            return x < dst_x ? cube + 1 : cube - 1;
+         else
+            return cube < dst_cube ? cube + _grid_width : cube - _grid_width;
+      }
+      default:
+         LOG_PRINT_ERROR("Invalid HMC topology %d", _topology);
+   }
+}
+
+/* Model one cube-to-cube link traversal. In: packet start time and size in FLITs. Out: arrival time at the next cube */
+SubsecondTime
+NetworkModelHmcLinkGlobal::useLink(UInt32 src_cube, UInt32 dst_cube, SubsecondTime t_start, UInt32 flits, subsecond_time_t *queue_delay_stats)
+{
+   Link *link = _links[src_cube * _num_cubes + dst_cube];
+   LOG_ASSERT_ERROR(link != NULL, "No HMC link between cube %u and cube %u", src_cube, dst_cube);
+
+   ScopedLock sl(link->_lock);
+
+   // Reclaim credits that were returned by the time this packet is ready to be sent
+   while (!link->_in_flight.empty() && link->_in_flight.top().first <= t_start)
+   {
+      link->_flits_in_flight -= link->_in_flight.top().second;
+      link->_in_flight.pop();
+   }
+   // Not enough buffer space downstream: wait for the oldest outstanding credits to come back
+   SubsecondTime t_credit = t_start;
+   while (!link->_in_flight.empty() && link->_flits_in_flight + flits > _link_credits)
+   {
+      t_credit = std::max(t_credit, link->_in_flight.top().first);
+      link->_flits_in_flight -= link->_in_flight.top().second;
+      link->_in_flight.pop();
+   }
+
+   SubsecondTime t_serialize = _link_bandwidth.getRoundedLatency(8 * flits * _flit_size);
+   SubsecondTime t_queue = link->_queue_model->computeQueueDelay(t_credit, t_serialize);
+   SubsecondTime t_arrive = t_credit + t_queue + t_serialize + _link_latency;
+
+   // The packet is forwarded on arrival, its credits travel back over the reverse link
+   link->_in_flight.push(std::make_pair(t_arrive + _link_latency, flits));
+   link->_flits_in_flight += flits;
+
+   link->_num_packets ++;
+   link->_num_flits += flits;
+   link->_time_used += t_serialize;
+   link->_total_queue_delay += t_queue;
+   link->_total_credit_delay += t_credit - t_start;
+   if (queue_delay_stats)
+      *queue_delay_stats += (t_credit - t_start) + t_queue;
+
+   return t_arrive;
+}
+
+NetworkModelHmcLink::NetworkModelHmcLink(Network *net, EStaticNetwork net_type)
+   : NetworkModel(net, net_type)
+   , _enabled(false)
+   , _control_bytes(0)
+   , _num_packets(0)
+   , _num_flits(0)
+   , _num_cube_hops(0)
+   , _total_delay(SubsecondTime::Zero())
+{
+   String name = String("network.")+EStaticNetworkStrings[net_type]+".hmc";
+   if (!_hmc_global[net_type]) {
+      _hmc_global[net_type] = new NetworkModelHmcLinkGlobal(name);
+   }
+   _hmc = _hmc_global[net_type];
+
+   if (net_type == STATIC_NETWORK_MEMORY_1)
+   {
+      // packet_type + sender + receiver + length (see Network::getModeledLength), and msg_type + address (see ShmemMsg::getModeledLength)
+      _control_bytes = 1 + 2 * Config::getSingleton()->getCoreIDLength() + 2 + 1 + sizeof(IntPtr);
+   }
+
+   core_id_t core_id = getNetwork()->getCore()->getId();
+   registerStatsMetric(name, core_id, "packets-out", &_num_packets);
+   registerStatsMetric(name, core_id, "flits-out", &_num_flits);
+   registerStatsMetric(name, core_id, "cube-hops", &_num_cube_hops);
+   registerStatsMetric(name, core_id, "total-delay", &_total_delay);
+}
+
+UInt32
+NetworkModelHmcLink::computeFlits(const NetPacket &pkt)
+{
+   UInt32 length = getNetwork()->getModeledLength(pkt);
+   UInt32 payload = length > _control_bytes ? length - _control_bytes : 0;
+   // One header/tail FLIT, plus the data payload rounded up to whole FLITs
+   return 1 + (payload + _hmc->_flit_size - 1) / _hmc->_flit_size;
+}
+
+SubsecondTime
+NetworkModelHmcLink::routeToCore(core_id_t sender, core_id_t receiver, SubsecondTime t_start, UInt32 flits, subsecond_time_t *queue_delay_stats)
+{
+   if (sender == receiver)
+      return t_start;
+
+   // Source vault to the cube's crossbar, then link by link towards the destination cube
+   SubsecondTime t = t_start + _hmc->_intra_cube_latency;
+   UInt32 cube = _hmc->getCube(sender), dst_cube = _hmc->getCube(receiver);
+   while (cube != dst_cube)
+   {
+      UInt32 next_cube = _hmc->getNextCube(cube, dst_cube);
+      t = _hmc->useLink(cube, next_cube, t, flits, queue_delay_stats);
+      cube = next_cube;
+      _num_cube_hops ++;
+   }
+   return t;
+}
+
+void
+NetworkModelHmcLink::routePacket(const NetPacket &pkt, std::vector<Hop> &nextHops)
+{
+   bool account = accountPacket(pkt);
+   UInt32 flits = 0;
+   if (account)
+   {
+      flits = computeFlits(pkt);
+      _num_packets ++;
+      _num_flits += flits;
+   }
+
+   if (pkt.receiver == NetPacket::BROADCAST)
+   {
+      UInt32 total_cores = Config::getSingleton()->getTotalCores();
+
+      for (SInt32 i = 0; i < (SInt32) total_cores; i++)
+      {
+         Hop h;
+         h.final_dest = i;
+         h.next_dest = i;
+         h.time = (account && i < (SInt32) Config::getSingleton()->getApplicationCores())
+            ? routeToCore(pkt.sender, i, pkt.time, flits, NULL) : SubsecondTime(pkt.time);
+
+         nextHops.push_back(h);
+      }
+   }
+   else
+   {
+      Hop h;
+      h.final_dest = pkt.receiver;
+      h.next_dest = pkt.receiver;
+      h.time = account ? routeToCore(pkt.sender, pkt.receiver, pkt.time, flits, (subsecond_time_t*)&pkt.queue_delay) : SubsecondTime(pkt.time);
+      _total_delay += h.time - pkt.time;
+
+      nextHops.push_back(h);
+   }
+}
+
+void
+NetworkModelHmcLink::processReceivedPacket(NetPacket &pkt)
+{
+}
+
+bool
+NetworkModelHmcLink::accountPacket(const NetPacket &pkt)
+{
+   core_id_t requester = INVALID_CORE_ID;
+
+   if (pkt.type == SHARED_MEM_1)
+      requester = getNetwork()->getCore()->getMemoryManager()->getShmemRequester(pkt.data);
+   else // Other Packet types
+      requester = pkt.sender;
+
+   LOG_ASSERT_ERROR((requester >= 0) && (requester < (core_id_t) Config::getSingleton()->getTotalCores()),
+         "requester(%i)", requester);
+
+   if (  !_enabled
+            // Data to/from MCP: admin traffic, don't account
+         || (requester >= (core_id_t) Config::getSingleton()->getApplicationCores())
+         || (pkt.sender >= (core_id_t) Config::getSingleton()->getApplicationCores())
+         || (pkt.receiver != NetPacket::BROADCAST && pkt.receiver >= (core_id_t) Config::getSingleton()->getApplicationCores())
+      )
+      return false;
+   else
+      return true;
+}
@@ -0,0 +1,107 @@
+#ifndef NETWORK_MODEL_HMC_LINK_H
+#define NETWORK_MODEL_HMC_LINK_H
+
+#include "network.h"
+#include "lock.h"
+#include "subsecond_time.h"
+#include "queue_model.h"
+
+#include <vector>
+#include <queue>
+
+// Network of chained HMC cubes.
+// Cores are grouped into cubes of network/hmc_link/cores_per_cube (one core per vault); traffic within a cube
+// only pays the vault crossbar latency, traffic between cubes is routed over SerDes links in a daisy chain,
+// a star (all cubes hang off cube 0) or a 2-D grid of cubes.
+// Packets are framed into 16-byte FLITs as in the HMC specification: one FLIT carries the header and tail
+// (command, address, and the coherence message header), followed by the data payload.
+// Read requests and write responses are therefore one FLIT, a 64-byte read response or write request is five.
+// Every link direction has a fixed number of input buffer credits (in FLITs), which are returned to
+// the sender one link latency after the packet has been forwarded.
+
+class NetworkModelHmcLinkGlobal
+{
+   public:
+      class Link
+      {
+         public:
+            Lock _lock;
+            QueueModel* _queue_model;
+            // FLITs in the downstream input buffer, ordered by the time their credits return
+            std::priority_queue<std::pair<SubsecondTime, UInt32>, std::vector<std::pair<SubsecondTime, UInt32> >, std::greater<std::pair<SubsecondTime, UInt32> > > _in_flight;
+            UInt32 _flits_in_flight;
+
+            UInt64 _num_packets;
+            UInt64 _num_flits;
+            SubsecondTime _time_used;
+            SubsecondTime _total_queue_delay;
+            SubsecondTime _total_credit_delay;
+
+            Link(String name, UInt32 id, String model_type, SubsecondTime min_processing_time);
+            ~Link();
+      };
+
+      typedef enum
+      {
+         DAISY_CHAIN,
+         STAR,
+         GRID,
+      } topology_t;
+
+      const UInt32 _cores_per_cube;
+      const UInt32 _num_cubes;
+      topology_t _topology;
+      UInt32 _grid_width;
+
+      const UInt32 _flit_size;
+      const UInt32 _link_credits;
+      const ComponentBandwidth _link_bandwidth;
+      const SubsecondTime _link_latency;
+      const SubsecondTime _intra_cube_latency;
+
+      // Indexed by src_cube * _num_cubes + dst_cube, NULL when the two cubes are not directly connected
+      std::vector<Link*> _links;
+
+      NetworkModelHmcLinkGlobal(String name);
+      ~NetworkModelHmcLinkGlobal();
+
+      UInt32 getCube(core_id_t core) const { return core / _cores_per_cube; }
+      UInt32 getNextCube(UInt32 cube, UInt32 dst_cube) const;
+      SubsecondTime useLink(UInt32 src_cube, UInt32 dst_cube, SubsecondTime t_start, UInt32 flits, subsecond_time_t *queue_delay_stats = NULL);
+};
+
+class NetworkModelHmcLink : public NetworkModel
+{
+   static NetworkModelHmcLinkGlobal* _hmc_global[NUM_STATIC_NETWORKS];
+
+   private:
+      bool _enabled;
+      NetworkModelHmcLinkGlobal* _hmc;
+      // Bytes of Sniper packet and coherence message header, carried in the HMC header/tail FLIT
+      UInt32 _control_bytes;
+
+      UInt64 _num_packets;
+      UInt64 _num_flits;
+      UInt64 _num_cube_hops;
+      SubsecondTime _total_delay;
+
+      bool accountPacket(const NetPacket &pkt);
+      UInt32 computeFlits(const NetPacket &pkt);
+      SubsecondTime routeToCore(core_id_t sender, core_id_t receiver, SubsecondTime t_start, UInt32 flits, subsecond_time_t *queue_delay_stats);
+
+   public:
+      NetworkModelHmcLink(Network *net, EStaticNetwork net_type);
+      ~NetworkModelHmcLink() {}
+
+      void routePacket(const NetPacket &pkt, std::vector<Hop> &nextHops);
+
+      void processReceivedPacket(NetPacket& pkt);
+
+      void enable()
+      { _enabled = true; }
+
+      void disable()
+      { _enabled = false; }
+};
+
+#endif /* NETWORK_MODEL_HMC_LINK_H */
@@ -17,6 +17,7 @@ BranchPredictor::BranchPredictor(String name, core_id_t core_id)
 {
   registerStatsMetric(name, core_id, "num-correct", &m_correct_predictions);
   registerStatsMetric(name, core_id, "num-incorrect", &m_incorrect_predictions);
+  Sim()->getCheckpointManager()->registerObject(name, core_id, this);
 }
 
 BranchPredictor::~BranchPredictor()
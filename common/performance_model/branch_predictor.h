@@ -4,8 +4,9 @@
 #include <iostream>
 
 #include "fixed_types.h"
+#include "checkpoint_manager.h"
 
-class BranchPredictor
+class BranchPredictor : public Checkpointable
 {
 public:
    BranchPredictor();
@@ -23,6 +24,10 @@ public:
 
    void resetCounters();
 
+   // Predictor tables, saved in checkpoints
+   virtual void saveCheckpoint(CheckpointWriter &writer) {}
+   virtual bool restoreCheckpoint(CheckpointReader &reader) { return true; }
+
 protected:
    void updateCounters(bool predicted, bool actual);
 
@@ -117,6 +117,37 @@ public:
       return;
    }
 
+   void saveCheckpoint(CheckpointWriter &writer)
+   {
+      writer.write(m_lru_use_count);
+      writer.write(m_num_ways);
+      for (unsigned int w = 0 ; w < m_num_ways ; ++w )
+      {
+         writer.writeArray(m_ways[w].m_valid);
+         writer.writeArray(m_ways[w].m_tags);
+         writer.writeArray(m_ways[w].m_predictors);
+         writer.writeArray(m_ways[w].m_lru);
+      }
+   }
+
+   bool restoreCheckpoint(CheckpointReader &reader)
+   {
+      // Read into a copy first, so a mismatching checkpoint leaves the predictor unchanged
+      UInt64 lru_use_count = reader.read<UInt64>();
+      if (reader.read<UInt32>() != m_num_ways)
+         return false;
+      std::vector<Way> ways(m_ways);
+      for (unsigned int w = 0 ; w < m_num_ways ; ++w )
+      {
+         if (!reader.readArray(ways[w].m_valid) || !reader.readArray(ways[w].m_tags)
+            || !reader.readArray(ways[w].m_predictors) || !reader.readArray(ways[w].m_lru))
+            return false;
+      }
+      m_lru_use_count = lru_use_count;
+      m_ways.swap(ways);
+      return true;
+   }
+
 private:
 
    class Way
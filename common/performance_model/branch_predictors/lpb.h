@@ -259,6 +259,42 @@ public:
 
    }
 
+   void saveCheckpoint(CheckpointWriter &writer)
+   {
+      writer.write(m_lru_use_count);
+      writer.write(m_num_ways);
+      for (UInt32 w = 0 ; w < m_num_ways ; ++w )
+      {
+         writer.writeArray(m_ways[w].m_tags);
+         writer.writeArray(m_ways[w].m_previous_actual);
+         writer.writeArray(m_ways[w].m_enabled);
+         writer.writeArray(m_ways[w].m_predictors);
+         writer.writeArray(m_ways[w].m_lru);
+         writer.writeArray(m_ways[w].m_count);
+         writer.writeArray(m_ways[w].m_limit);
+      }
+   }
+
+   bool restoreCheckpoint(CheckpointReader &reader)
+   {
+      // Read into a copy first, so a mismatching checkpoint leaves the predictor unchanged
+      UInt64 lru_use_count = reader.read<UInt64>();
+      if (reader.read<UInt32>() != m_num_ways)
+         return false;
+      std::vector<Way> ways(m_ways);
+      for (UInt32 w = 0 ; w < m_num_ways ; ++w )
+      {
+         if (!reader.readArray(ways[w].m_tags) || !reader.readArray(ways[w].m_previous_actual)
+            || !reader.readArray(ways[w].m_enabled) || !reader.readArray(ways[w].m_predictors)
+            || !reader.readArray(ways[w].m_lru) || !reader.readArray(ways[w].m_count)
+            || !reader.readArray(ways[w].m_limit))
+            return false;
+      }
+      m_lru_use_count = lru_use_count;
+      m_ways.swap(ways);
+      return true;
+   }
+
 private:
 
    class Way
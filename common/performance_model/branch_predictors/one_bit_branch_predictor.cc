@@ -23,3 +23,13 @@ void OneBitBranchPredictor::update(bool predicted, bool actual, IntPtr ip, IntPt
    UInt32 index = ip % m_bits.size();
    m_bits[index] = actual;
 }
+
+void OneBitBranchPredictor::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.writeArray(m_bits);
+}
+
+bool OneBitBranchPredictor::restoreCheckpoint(CheckpointReader &reader)
+{
+   return reader.readArray(m_bits);
+}
@@ -86,3 +86,32 @@ void PentiumMBranchPredictor::update_pir(bool actual, IntPtr ip, IntPtr target,
 
    m_pir = ((m_pir << 2) ^ rhs) & 0x7fff;
 }
+
+void PentiumMBranchPredictor::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.write(m_pir);
+   m_global_predictor.saveCheckpoint(writer);
+   m_btb.saveCheckpoint(writer);
+   m_bimodal_table.saveCheckpoint(writer);
+   m_lpb.saveCheckpoint(writer);
+}
+
+bool PentiumMBranchPredictor::restoreCheckpoint(CheckpointReader &reader)
+{
+   // Restore into copies of the tables, so a mismatching checkpoint leaves the predictor unchanged
+   IntPtr pir = reader.read<IntPtr>();
+   PentiumMGlobalPredictor global_predictor(m_global_predictor);
+   PentiumMBranchTargetBuffer btb(m_btb);
+   PentiumMBimodalTable bimodal_table(m_bimodal_table);
+   PentiumMLoopBranchPredictor lpb(m_lpb);
+   if (!global_predictor.restoreCheckpoint(reader) || !btb.restoreCheckpoint(reader)
+      || !bimodal_table.restoreCheckpoint(reader) || !lpb.restoreCheckpoint(reader))
+      return false;
+
+   m_pir = pir;
+   m_global_predictor = global_predictor;
+   m_btb = btb;
+   m_bimodal_table = bimodal_table;
+   m_lpb = lpb;
+   return true;
+}
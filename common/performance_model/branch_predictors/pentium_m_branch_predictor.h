@@ -20,6 +20,9 @@ public:
 
    void update(bool predicted, bool actual, IntPtr ip, IntPtr target);
 
+   void saveCheckpoint(CheckpointWriter &writer);
+   bool restoreCheckpoint(CheckpointReader &reader);
+
 private:
 
    void update_pir(bool actual, IntPtr ip, IntPtr target, BranchPredictorReturnValue::BranchType branch_type);
@@ -90,6 +90,31 @@ public:
       m_ways[lru_way].m_plru[index] = m_lru_use_count++;
    }
 
+   void saveCheckpoint(CheckpointWriter &writer)
+   {
+      writer.write(m_lru_use_count);
+      for (unsigned int w = 0 ; w < NUM_WAYS ; ++w )
+      {
+         writer.writeArray(m_ways[w].m_tag_offset);
+         writer.writeArray(m_ways[w].m_plru);
+      }
+   }
+
+   bool restoreCheckpoint(CheckpointReader &reader)
+   {
+      // Read into a copy first, so a mismatching checkpoint leaves the predictor unchanged
+      UInt64 lru_use_count = reader.read<UInt64>();
+      std::vector<Way> ways(m_ways);
+      for (unsigned int w = 0 ; w < NUM_WAYS ; ++w )
+      {
+         if (!reader.readArray(ways[w].m_tag_offset) || !reader.readArray(ways[w].m_plru))
+            return false;
+      }
+      m_lru_use_count = lru_use_count;
+      m_ways.swap(ways);
+      return true;
+   }
+
 private:
    std::vector<Way> m_ways;
    UInt64 m_lru_use_count;
@@ -42,6 +42,16 @@ public:
       }
    }
 
+   void saveCheckpoint(CheckpointWriter &writer)
+   {
+      writer.writeArray(m_table);
+   }
+
+   bool restoreCheckpoint(CheckpointReader &reader)
+   {
+      return reader.readArray(m_table);
+   }
+
    void reset()
    {
       for (unsigned int i = 0 ; i < m_num_entries ; i++) {
@@ -3,6 +3,7 @@
 #include "dram_perf_model_constant.h"
 #include "dram_perf_model_readwrite.h"
 #include "dram_perf_model_normal.h"
+#include "dram_perf_model_hmc.h"
 #include "config.hpp"
 using namespace std;
 DramPerfModel* DramPerfModel::createDramPerfModel(core_id_t core_id, UInt32 cache_block_size)
@@ -21,6 +22,10 @@ DramPerfModel* DramPerfModel::createDramPerfModel(core_id_t core_id, UInt32 cach
    {  cout << "[LINGXI]: in /common/perf_model/dram_perf_model_base.h create a normal dram_perf_mdl" << endl; 
       return new DramPerfModelNormal(core_id, cache_block_size);
    }
+   else if (type == "hmc")
+   {
+      return new DramPerfModelHMC(core_id, cache_block_size);
+   }
    else
    {
       LOG_PRINT_ERROR("Invalid DRAM model type %s", type.c_str());
@@ -5,6 +5,7 @@
 #include "fixed_types.h"
 #include "subsecond_time.h"
 #include "dram_cntlr_interface.h"
+#include "hmc_address_map.h"
 
 
 class ShmemPerf;
@@ -72,15 +73,10 @@ class DramPerfModel
        */
       int max_parallel_requests = 100;
 
-      static int getBank(IntPtr address){	
-return 0;
-      }   
-      static int getVault(IntPtr address){
-return 0;
-      }	
-      static int getCube(IntPtr address){
-return 0;
-      }	      
+      // Address mapping is configured through [perf_model/dram/hmc], see hmc_address_map.h
+      static int getBank(IntPtr address) { return HmcAddressMap::getSingleton()->getBank(address); }
+      static int getVault(IntPtr address) { return HmcAddressMap::getSingleton()->getVault(address); }
+      static int getCube(IntPtr address) { return HmcAddressMap::getSingleton()->getCube(address); }
       UInt64 getTotalAccesses() { return m_num_accesses; }
 };
 
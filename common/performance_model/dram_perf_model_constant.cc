@@ -5,7 +5,6 @@
 #include "stats.h"
 #include "shmem_perf.h"
 
-#include <fstream>
 
 using namespace std;
 DramPerfModelConstant::DramPerfModelConstant(core_id_t core_id,
@@ -83,13 +82,6 @@ DramPerfModelConstant::getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size,
 */
 //   getBank(address);
 
-/*
-ofstream myfile;
-myfile.open("mem_addr_trace.txt", ios::app);
-myfile << to_string(address) << endl;
-myfile.close();
-*/
-
    SubsecondTime access_latency = queue_delay + processing_time + m_dram_access_cost;
 /*
    cout << "[LINGXI]: in /common/perf_model/dram_perf_const::getAccessLatency" 
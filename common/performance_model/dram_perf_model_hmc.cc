@@ -0,0 +1,155 @@
+#include "dram_perf_model_hmc.h"
+#include "hmc_address_map.h"
+#include "simulator.h"
+#include "config.h"
+#include "config.hpp"
+#include "stats.h"
+#include "shmem_perf.h"
+#include "utils.h"
+
+static SubsecondTime getTimingParameter(String name)
+{
+   // Operate in fs for higher precision before converting to uint64_t/SubsecondTime
+   return SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/hmc/timing/" + name)));
+}
+
+DramPerfModelHMC::DramPerfModelHMC(core_id_t core_id,
+      UInt32 cache_block_size):
+   DramPerfModel(core_id, cache_block_size),
+   m_address_map(HmcAddressMap::getSingleton()),
+   m_vault_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/hmc/intra_vault_bandwidth")), // Convert bytes to bits
+   m_tRCD(getTimingParameter("tRCD")),
+   m_tCL(getTimingParameter("tCL")),
+   m_tRP(getTimingParameter("tRP")),
+   m_tRAS(getTimingParameter("tRAS")),
+   m_fr_fcfs(Sim()->getCfg()->getBool("perf_model/dram/hmc/fr_fcfs")),
+   m_row_hits(0),
+   m_row_misses(0),
+   m_row_conflicts(0),
+   m_total_bank_delay(SubsecondTime::Zero()),
+   m_total_bus_delay(SubsecondTime::Zero()),
+   m_total_access_latency(SubsecondTime::Zero())
+{
+   String page_policy = Sim()->getCfg()->getString("perf_model/dram/hmc/page_policy");
+   if (page_policy == "open")
+      m_open_page = true;
+   else if (page_policy == "closed")
+      m_open_page = false;
+   else
+      LOG_PRINT_ERROR("Invalid perf_model/dram/hmc/page_policy %s", page_policy.c_str());
+
+   m_vaults.resize(m_address_map->getTotalVaults());
+   for(std::vector<Vault>::iterator it = m_vaults.begin(); it != m_vaults.end(); ++it)
+      it->banks.resize(m_address_map->getBanksPerVault());
+
+   registerStatsMetric("dram", core_id, "total-access-latency", &m_total_access_latency);
+   registerStatsMetric("dram", core_id, "total-bank-delay", &m_total_bank_delay);
+   registerStatsMetric("dram", core_id, "total-bus-delay", &m_total_bus_delay);
+   registerStatsMetric("dram", core_id, "row-hits", &m_row_hits);
+   registerStatsMetric("dram", core_id, "row-misses", &m_row_misses);
+   registerStatsMetric("dram", core_id, "row-conflicts", &m_row_conflicts);
+
+   Sim()->getCheckpointManager()->registerObject("dram", core_id, this);
+}
+
+DramPerfModelHMC::~DramPerfModelHMC()
+{
+}
+
+SubsecondTime
+DramPerfModelHMC::getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size, core_id_t requester, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf)
+{
+   if ((!m_enabled) ||
+         (requester >= (core_id_t) Config::getSingleton()->getApplicationCores()))
+   {
+      return SubsecondTime::Zero();
+   }
+
+   Vault &vault = m_vaults[m_address_map->getGlobalVault(address)];
+   Bank &bank = vault.banks[m_address_map->getBank(address)];
+   UInt64 row = m_address_map->getRow(address);
+   SubsecondTime transfer_time = m_vault_bandwidth.getRoundedLatency(8 * pkt_size); // bytes to bits
+
+   SubsecondTime bank_start, column_done;
+   if (bank.open_row == row)
+   {
+      // Row hit: only the column access is needed. With FR-FCFS, hits pipeline behind earlier column accesses
+      ++m_row_hits;
+      bank_start = getMax(pkt_time, m_fr_fcfs ? bank.column_free : bank.busy_until);
+      column_done = bank_start + m_tCL;
+   }
+   else
+   {
+      bank_start = getMax(pkt_time, bank.busy_until);
+      SubsecondTime activate_time = bank_start;
+      if (bank.open_row == NO_OPEN_ROW)
+      {
+         ++m_row_misses;
+      }
+      else
+      {
+         // Row conflict: precharge the open row, which cannot happen before tRAS has elapsed since its activation
+         ++m_row_conflicts;
+         activate_time = getMax(bank_start, bank.activate_time + m_tRAS) + m_tRP;
+      }
+      bank.activate_time = activate_time;
+      bank.open_row = row;
+      column_done = activate_time + m_tRCD + m_tCL;
+   }
+   // The next row hit can issue its column command once this access's column command (issued tCL before
+   // column_done, after precharge/activate for a row miss or conflict) has moved its data out of the bank
+   bank.column_free = column_done - m_tCL + transfer_time;
+   bank.busy_until = getMax(bank.busy_until, column_done);
+
+   if (!m_open_page)
+   {
+      // Closed page policy: auto-precharge once the access (and tRAS) completes
+      bank.busy_until = getMax(column_done, bank.activate_time + m_tRAS) + m_tRP;
+      bank.open_row = NO_OPEN_ROW;
+   }
+
+   // Transfer the data over the vault's TSV bus
+   SubsecondTime bus_start = getMax(column_done, vault.bus_free);
+   vault.bus_free = bus_start + transfer_time;
+
+   SubsecondTime bank_delay = bank_start - pkt_time;
+   SubsecondTime bus_delay = bus_start - column_done;
+   SubsecondTime access_latency = vault.bus_free - pkt_time;
+
+   perf->updateTime(pkt_time);
+   perf->updateTime(bank_start, ShmemPerf::DRAM_QUEUE);
+   perf->updateTime(column_done, ShmemPerf::DRAM_DEVICE);
+   perf->updateTime(bus_start, ShmemPerf::DRAM_QUEUE);
+   perf->updateTime(vault.bus_free, ShmemPerf::DRAM_BUS);
+
+   // Update Memory Counters
+   m_num_accesses ++;
+   m_total_access_latency += access_latency;
+   m_total_bank_delay += bank_delay;
+   m_total_bus_delay += bus_delay;
+
+   return access_latency;
+}
+
+void
+DramPerfModelHMC::saveCheckpoint(CheckpointWriter &writer)
+{
+   writer.write(UInt32(m_vaults.size()));
+   writer.write(m_address_map->getBanksPerVault());
+   writer.write(UInt32(m_address_map->getMapping()));
+   for(std::vector<Vault>::iterator it = m_vaults.begin(); it != m_vaults.end(); ++it)
+      for(std::vector<Bank>::iterator bank = it->banks.begin(); bank != it->banks.end(); ++bank)
+         writer.write(bank->open_row);
+}
+
+bool
+DramPerfModelHMC::restoreCheckpoint(CheckpointReader &reader)
+{
+   if (reader.read<UInt32>() != m_vaults.size() || reader.read<UInt32>() != m_address_map->getBanksPerVault()
+      || reader.read<UInt32>() != UInt32(m_address_map->getMapping()))
+      return false;
+   for(std::vector<Vault>::iterator it = m_vaults.begin(); it != m_vaults.end(); ++it)
+      for(std::vector<Bank>::iterator bank = it->banks.begin(); bank != it->banks.end(); ++bank)
+         reader.read(bank->open_row);
+   return true;
+}
@@ -0,0 +1,71 @@
+#ifndef __DRAM_PERF_MODEL_HMC_H__
+#define __DRAM_PERF_MODEL_HMC_H__
+
+#include "dram_perf_model.h"
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "dram_cntlr_interface.h"
+#include "checkpoint_manager.h"
+
+#include <vector>
+
+class HmcAddressMap;
+
+// Per-vault, per-bank HMC timing model.
+// Every vault has its own controller with a TSV data bus (perf_model/dram/hmc/intra_vault_bandwidth),
+// every bank keeps its open row and the times at which it can accept the next row or column command.
+// Requests are timed in the order they are simulated; FR-FCFS is approximated by letting row hits
+// pipeline behind earlier column accesses, while row misses wait until the bank is idle.
+class DramPerfModelHMC : public DramPerfModel, public Checkpointable
+{
+   private:
+      static const UInt64 NO_OPEN_ROW = ~UInt64(0);
+
+      struct Bank
+      {
+         Bank()
+            : open_row(NO_OPEN_ROW)
+            , activate_time(SubsecondTime::Zero())
+            , column_free(SubsecondTime::Zero())
+            , busy_until(SubsecondTime::Zero())
+         {}
+         UInt64 open_row;
+         SubsecondTime activate_time;  // Time of the last ACTIVATE, used to enforce tRAS
+         SubsecondTime column_free;    // Earliest time a row hit can issue its column command
+         SubsecondTime busy_until;     // Earliest time a row miss can start precharging/activating
+      };
+
+      struct Vault
+      {
+         Vault() : bus_free(SubsecondTime::Zero()) {}
+         std::vector<Bank> banks;
+         SubsecondTime bus_free;       // TSV data bus is occupied until this time
+      };
+
+      const HmcAddressMap* m_address_map;
+      std::vector<Vault> m_vaults;     // Indexed by global vault, only vaults homed at this controller are touched
+
+      ComponentBandwidth m_vault_bandwidth;
+      SubsecondTime m_tRCD, m_tCL, m_tRP, m_tRAS;
+      bool m_open_page;
+      bool m_fr_fcfs;
+
+      UInt64 m_row_hits, m_row_misses, m_row_conflicts;
+      SubsecondTime m_total_bank_delay;
+      SubsecondTime m_total_bus_delay;
+      SubsecondTime m_total_access_latency;
+
+   public:
+      DramPerfModelHMC(core_id_t core_id,
+            UInt32 cache_block_size);
+
+      ~DramPerfModelHMC();
+
+      SubsecondTime getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size, core_id_t requester, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf);
+
+      // Only the open row of each bank is saved, bank and bus busy times restart from zero
+      void saveCheckpoint(CheckpointWriter &writer);
+      bool restoreCheckpoint(CheckpointReader &reader);
+};
+
+#endif /* __DRAM_PERF_MODEL_HMC_H__ */
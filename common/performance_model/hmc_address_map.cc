@@ -0,0 +1,81 @@
+#include "hmc_address_map.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "utils.h"
+#include "log.h"
+
+HmcAddressMap*
+HmcAddressMap::getSingleton()
+{
+   // Thread-safe construction on first use (C++11 magic statics), after the configuration has been loaded
+   static HmcAddressMap s_address_map(
+      parseMapping(Sim()->getCfg()->getString("perf_model/dram/hmc/address_mapping")),
+      Sim()->getCfg()->getInt("perf_model/dram/hmc/cubes"),
+      Sim()->getCfg()->getInt("perf_model/dram/hmc/vaults_per_cube"),
+      Sim()->getCfg()->getInt("perf_model/dram/hmc/banks_per_vault"),
+      Sim()->getCfg()->getInt("perf_model/dram/hmc/block_size"),
+      Sim()->getCfg()->getInt("perf_model/dram/hmc/page_size"),
+      Sim()->getCfg()->getBool("perf_model/dram/hmc/enabled"));
+   return &s_address_map;
+}
+
+HmcAddressMap::HmcAddressMap(mapping_t mapping, UInt32 num_cubes, UInt32 vaults_per_cube, UInt32 banks_per_vault,
+      UInt32 block_size, UInt32 page_size, bool enabled)
+   : m_enabled(enabled)
+   , m_mapping(mapping)
+   , m_num_cubes(num_cubes)
+   , m_vaults_per_cube(vaults_per_cube)
+   , m_banks_per_vault(banks_per_vault)
+   , m_block_size(block_size)
+   , m_page_size(page_size)
+{
+   LOG_ASSERT_ERROR(isPower2(num_cubes), "HMC cubes (%u) must be a power of two", num_cubes);
+   LOG_ASSERT_ERROR(isPower2(vaults_per_cube), "HMC vaults_per_cube (%u) must be a power of two", vaults_per_cube);
+   LOG_ASSERT_ERROR(isPower2(banks_per_vault), "HMC banks_per_vault (%u) must be a power of two", banks_per_vault);
+   LOG_ASSERT_ERROR(isPower2(block_size), "HMC block_size (%u) must be a power of two", block_size);
+   LOG_ASSERT_ERROR(isPower2(page_size), "HMC page_size (%u) must be a power of two", page_size);
+
+   UInt32 cube_bits = floorLog2(num_cubes);
+   UInt32 bank_bits = floorLog2(banks_per_vault);
+   m_vault_bits = floorLog2(vaults_per_cube);
+
+   m_vault_shift = floorLog2(mapping == PAGE ? page_size : block_size);
+   m_cube_shift = m_vault_shift + m_vault_bits;
+   m_bank_shift = m_cube_shift + cube_bits;
+   m_row_shift = m_bank_shift + bank_bits;
+   m_bank_xor_shift = m_row_shift + m_vault_bits;
+
+   m_vault_mask = (UInt64(1) << m_vault_bits) - 1;
+   m_cube_mask = (UInt64(1) << cube_bits) - 1;
+   m_bank_mask = (UInt64(1) << bank_bits) - 1;
+   m_offset_mask = (UInt64(1) << m_vault_shift) - 1;
+
+   // Without hashing, the xor term is masked to zero so the lookup stays branch-free
+   m_vault_xor_mask = mapping == XOR ? m_vault_mask : 0;
+   m_bank_xor_mask = mapping == XOR ? m_bank_mask : 0;
+}
+
+HmcAddressMap::mapping_t
+HmcAddressMap::parseMapping(String mapping)
+{
+   if (mapping == "vault_interleave")
+      return VAULT_INTERLEAVE;
+   else if (mapping == "xor")
+      return XOR;
+   else if (mapping == "page")
+      return PAGE;
+   else
+      LOG_PRINT_ERROR("Invalid HMC address mapping %s", mapping.c_str());
+}
+
+String
+HmcAddressMap::MappingString(mapping_t mapping)
+{
+   switch(mapping)
+   {
+      case VAULT_INTERLEAVE:  return "vault_interleave";
+      case XOR:               return "xor";
+      case PAGE:              return "page";
+      default:                return "unknown";
+   }
+}
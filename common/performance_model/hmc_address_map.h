@@ -0,0 +1,98 @@
+#ifndef __HMC_ADDRESS_MAP_H__
+#define __HMC_ADDRESS_MAP_H__
+
+#include "fixed_types.h"
+
+// Maps a physical address onto the HMC geometry (cube, vault, bank, row).
+// All geometry parameters must be powers of two so that every lookup can be
+// done with a handful of shifts, masks and xors, precomputed at construction.
+//
+// Address layout, from LSB to MSB:
+//
+//   vault_interleave: | block offset | vault | cube | bank | row |
+//   xor:              same as vault_interleave, but vault and bank are xor-ed
+//                     with the low-order row bits (permutation-based interleaving)
+//   page:             | page offset  | vault | cube | bank | row |
+//
+// Configured from [perf_model/dram/hmc].
+class HmcAddressMap
+{
+   public:
+      enum mapping_t
+      {
+         VAULT_INTERLEAVE,
+         XOR,
+         PAGE,
+      };
+
+      static HmcAddressMap* getSingleton();
+
+      HmcAddressMap(mapping_t mapping, UInt32 num_cubes, UInt32 vaults_per_cube, UInt32 banks_per_vault,
+         UInt32 block_size, UInt32 page_size, bool enabled);
+
+      bool isEnabled() const { return m_enabled; }
+      mapping_t getMapping() const { return m_mapping; }
+
+      UInt32 getNumCubes() const { return m_num_cubes; }
+      UInt32 getVaultsPerCube() const { return m_vaults_per_cube; }
+      UInt32 getBanksPerVault() const { return m_banks_per_vault; }
+      UInt32 getTotalVaults() const { return m_num_cubes * m_vaults_per_cube; }
+      UInt32 getBlockSize() const { return m_block_size; }
+      UInt32 getPageSize() const { return m_page_size; }
+
+      UInt32 getVault(IntPtr address) const
+      {
+         return ((address >> m_vault_shift) ^ ((address >> m_row_shift) & m_vault_xor_mask)) & m_vault_mask;
+      }
+      UInt32 getBank(IntPtr address) const
+      {
+         return ((address >> m_bank_shift) ^ ((address >> m_bank_xor_shift) & m_bank_xor_mask)) & m_bank_mask;
+      }
+      UInt32 getCube(IntPtr address) const
+      {
+         return (address >> m_cube_shift) & m_cube_mask;
+      }
+      // Vault index across all cubes: cube * vaults_per_cube + vault
+      UInt32 getGlobalVault(IntPtr address) const
+      {
+         return (getCube(address) << m_vault_bits) | getVault(address);
+      }
+      UInt64 getRow(IntPtr address) const
+      {
+         return address >> m_row_shift;
+      }
+      // Address with the vault and cube fields squeezed out, unique within a single (global) vault
+      IntPtr getVaultLocalAddress(IntPtr address) const
+      {
+         return ((address >> m_bank_shift) << m_vault_shift) | (address & m_offset_mask);
+      }
+      // Number of low-order address bits that are never used to select a vault
+      UInt32 getOffsetBits() const { return m_vault_shift; }
+
+      static mapping_t parseMapping(String mapping);
+      static String MappingString(mapping_t mapping);
+
+   private:
+      const bool m_enabled;
+      const mapping_t m_mapping;
+      const UInt32 m_num_cubes;
+      const UInt32 m_vaults_per_cube;
+      const UInt32 m_banks_per_vault;
+      const UInt32 m_block_size;
+      const UInt32 m_page_size;
+
+      UInt32 m_vault_bits;
+      UInt32 m_vault_shift;
+      UInt32 m_cube_shift;
+      UInt32 m_bank_shift;
+      UInt32 m_bank_xor_shift;
+      UInt32 m_row_shift;
+      UInt64 m_vault_mask;
+      UInt64 m_vault_xor_mask;
+      UInt64 m_cube_mask;
+      UInt64 m_bank_mask;
+      UInt64 m_bank_xor_mask;
+      UInt64 m_offset_mask;
+};
+
+#endif /* __HMC_ADDRESS_MAP_H__ */
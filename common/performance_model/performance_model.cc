@@ -14,6 +14,8 @@
 #include "instruction_tracer.h"
 #include "dynamic_instruction.h"
 
+#include <sched.h>
+
 PerformanceModel* PerformanceModel::create(Core* core)
 {
    String type;
@@ -38,7 +40,11 @@ PerformanceModel* PerformanceModel::create(Core* core)
       if (smt_threads == 1)
          return new RobPerformanceModel(core);
       else
+      {
+         // The SMT model interleaves the instruction streams of its hardware threads, which need to stay in lock step
+         LOG_ASSERT_ERROR(!Sim()->getCfg()->getBool("perf_model/core/own_thread"), "perf_model/core/own_thread is not supported with SMT (logical_cpus > 1)");
          return new RobSmtPerformanceModel(core);
+      }
    }
    else
    {
@@ -55,15 +61,14 @@ PerformanceModel::PerformanceModel(Core *core)
    , m_fastforward(false)
    , m_fastforward_model(new FastforwardPerformanceModel(core, this))
    , m_detailed_sync(true)
-   , m_hold(false)
+   , m_own_thread(Sim()->getCfg()->getBool("perf_model/core/own_thread"))
+   , m_in_iterate(false)
    , m_instruction_count(0)
    , m_elapsed_time(Sim()->getDvfsManager()->getCoreDomain(core->getId()))
    , m_idle_elapsed_time(Sim()->getDvfsManager()->getCoreDomain(core->getId()))
-   #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-   , m_instruction_queue(256) // Reduce from default size to keep memory issue time more or less synchronized
-   #else
-   , m_instruction_queue(1024) // Need a bit more space for when the dyninsninfo items aren't coming in yet, or for a boatload of TLBMissInstructions
-   #endif
+   , m_instruction_queue(m_own_thread
+      ? 256 // Reduce from default size to keep memory issue time more or less synchronized
+      : 1024) // Need a bit more space for when the dyninsninfo items aren't coming in yet, or for a boatload of TLBMissInstructions
    , m_current_ins_index(0)
 {
    m_bp = BranchPredictor::create(core->getId());
@@ -163,6 +168,8 @@ void PerformanceModel::queuePseudoInstruction(PseudoInstruction *i)
 
    if (i->isIdle())
    {
+      // Idle instructions update time directly, make sure everything queued before them has been simulated
+      drain();
       handleIdleInstruction(i);
       delete i;
    }
@@ -172,13 +179,13 @@ void PerformanceModel::queuePseudoInstruction(PseudoInstruction *i)
       {
          m_fastforward_model->queuePseudoInstruction(i);
       }
+      else if (m_own_thread)
+      {
+         m_instruction_queue.push_wait(createDynamicInstruction(i, 0));
+      }
       else
       {
-         #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-            m_instruction_queue.push_wait(createDynamicInstruction(i, 0));
-         #else
-            m_instruction_queue.push(createDynamicInstruction(i, 0));
-         #endif
+         m_instruction_queue.push(createDynamicInstruction(i, 0));
       }
    }
 }
@@ -193,11 +200,10 @@ void PerformanceModel::queueInstruction(DynamicInstruction *ins)
       return;
    }
 
-   #ifdef ENABLE_PERF_MODEL_OWN_THREAD
+   if (m_own_thread)
       m_instruction_queue.push_wait(ins);
-   #else
+   else
       m_instruction_queue.push(ins);
-   #endif
 }
 
 void PerformanceModel::handleIdleInstruction(PseudoInstruction *instruction)
@@ -291,16 +297,22 @@ void PerformanceModel::handleIdleInstruction(PseudoInstruction *instruction)
       m_fastforward_model->notifyElapsedTimeUpdate();
 }
 
-void PerformanceModel::iterate()
+bool PerformanceModel::iterate()
 {
-   while (m_instruction_queue.size() > 0)
+   if (m_own_thread)
    {
-      // While the functional thread is waiting because of clock skew minimization, wait here as well
-      #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-      while(m_hold)
-         sched_yield();
-      #endif
+      // Instructions are only simulated by our CoreThread, the application thread just queues them.
+      // The CoreThread polls continuously: don't enter the barrier on behalf of an application thread
+      // that may not even be running on this core anymore.
+      if (!Sim()->getCoreManager()->amiCoreThread() || m_instruction_queue.empty())
+         return false;
+
+      m_in_iterate = true;
+      __sync_synchronize();
+   }
 
+   while (!m_instruction_queue.empty())
+   {
       DynamicInstruction *ins = m_instruction_queue.front();
 
       LOG_ASSERT_ERROR(!ins->instruction->isIdle(), "Idle instructions should not make it here!");
@@ -310,10 +322,40 @@ void PerformanceModel::iterate()
 
       delete ins;
 
+      // Only now release the slot, drain() relies on an empty queue meaning everything was simulated
       m_instruction_queue.pop();
    }
 
-   synchronize();
+   // The application thread may have been moved off this core while we were still simulating its last instructions
+   if (!m_own_thread || m_core->getState() == Core::RUNNING)
+      synchronize();
+
+   if (m_own_thread)
+   {
+      __sync_synchronize();
+      m_in_iterate = false;
+   }
+
+   return true;
+}
+
+void PerformanceModel::drain()
+{
+   // With the performance model on its own thread, wait until it has caught up with everything queued so far.
+   // The CoreThread itself can get here through pseudo instructions queued from within the memory subsystem.
+   if (m_own_thread && !Sim()->getCoreManager()->amiCoreThread())
+   {
+      // Check the queue first: it only empties while m_in_iterate is set, so seeing both an empty queue
+      // and a cleared flag means the iteration that took the last instruction has left the barrier
+      while (true)
+      {
+         bool empty = m_instruction_queue.empty();
+         __sync_synchronize();
+         if (empty && !m_in_iterate)
+            break;
+         sched_yield();
+      }
+   }
 }
 
 void PerformanceModel::synchronize()
@@ -3,7 +3,7 @@
 // This class represents the actual performance model for a given core
 
 #include "fixed_types.h"
-#include "mt_circular_queue.h"
+#include "lockfree_circular_queue.h"
 #include "lock.h"
 #include "subsecond_time.h"
 #include "instruction_tracer.h"
@@ -30,7 +30,8 @@ public:
    void queueInstruction(DynamicInstruction *i);
    void queuePseudoInstruction(PseudoInstruction *i);
    void handleIdleInstruction(PseudoInstruction *i);
-   void iterate();
+   bool iterate();
+   void drain();
    virtual void synchronize();
 
    UInt64 getInstructionCount() const { return m_instruction_count; }
@@ -64,7 +65,8 @@ public:
    void disable();
    void enable();
    bool isEnabled() { return m_enabled; }
-   void setHold(bool hold) { m_hold = hold; }
+   // Instructions are simulated by a dedicated CoreThread rather than by the thread that queues them
+   bool hasOwnThread() const { return m_own_thread; }
 
    bool isFastForward() { return m_fastforward; }
    void setFastForward(bool fastforward, bool detailed_sync = true)
@@ -91,11 +93,8 @@ protected:
    void incrementElapsedTime(SubsecondTime time) { m_elapsed_time.addLatency(time); }
    void incrementIdleElapsedTime(SubsecondTime time);
 
-   #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-      typedef MTCircularQueue<DynamicInstruction*> InstructionQueue;
-   #else
-      typedef CircularQueue<DynamicInstruction*> InstructionQueue;
-   #endif
+   // Filled by the application (trace) thread, drained by iterate() which can run on the CoreThread
+   typedef LockFreeCircularQueue<DynamicInstruction*> InstructionQueue;
 
    Core* getCore() { return m_core; }
 
@@ -120,7 +119,10 @@ private:
    FastforwardPerformanceModel* m_fastforward_model;
    bool m_detailed_sync;
 
-   bool m_hold;
+   const bool m_own_thread;
+   // Set by the CoreThread from before it takes the first instruction until synchronize() returned,
+   // so drain() also waits for the barrier instead of only for the queue to empty
+   volatile bool m_in_iterate;
 
 protected:
    UInt64 m_instruction_count;
@@ -41,6 +41,8 @@ RobTimer::RobTimer(
       , rob(window_size + 255)
       , m_num_in_rob(0)
       , m_rs_entries_used(0)
+      , m_done_tree_size(window_size + 256) // At least the ROB size (window_size + 255), so no two uops in the ROB share a slot
+      , m_done_tree(2 * m_done_tree_size, SubsecondTime::MaxTime())
       , m_rob_contention(
          Sim()->getCfg()->getBoolArray("perf_model/core/rob_timer/issue_contention", core->getId())
          ? core_model->createRobContentionModel(core)
@@ -250,6 +252,51 @@ RobTimer::RobEntry *RobTimer::findEntryBySequenceNumber(UInt64 sequenceNumber)
    return entry;
 }
 
+void RobTimer::setDoneTime(UInt64 sequenceNumber, SubsecondTime done)
+{
+   uint64_t idx = m_done_tree_size + sequenceNumber % m_done_tree_size;
+   m_done_tree[idx] = done;
+   for(idx /= 2; idx >= 1; idx /= 2)
+      m_done_tree[idx] = std::min(m_done_tree[2*idx], m_done_tree[2*idx+1]);
+}
+
+SubsecondTime RobTimer::getMinDoneTime(UInt64 first, UInt64 last)
+{
+   // Minimum done time of all issued uops with first <= sequence number <= last, which may wrap around the tree
+   SubsecondTime result = SubsecondTime::MaxTime();
+   if (last < first)
+      return result;
+   LOG_ASSERT_ERROR(last - first < m_done_tree_size, "Sequence number range %ld-%ld larger than the ROB", first, last);
+
+   uint64_t lo = first % m_done_tree_size, hi = last % m_done_tree_size;
+   uint64_t ranges[2][2] = { { lo, hi + 1 }, { 0, 0 } };
+   if (hi < lo)
+   {
+      ranges[0][1] = m_done_tree_size;
+      ranges[1][1] = hi + 1;
+   }
+   for(unsigned int r = 0; r < 2; ++r)
+   {
+      for(uint64_t l = ranges[r][0] + m_done_tree_size, h = ranges[r][1] + m_done_tree_size; l < h; l /= 2, h /= 2)
+      {
+         if (l & 1)
+            result = std::min(result, m_done_tree[l++]);
+         if (h & 1)
+            result = std::min(result, m_done_tree[--h]);
+      }
+   }
+   return result;
+}
+
+uint64_t RobTimer::getFirstUnresolvedStore()
+{
+   // Oldest store that is still waiting for a producer, and whose address is not yet known
+   for(std::set<uint64_t>::iterator it = m_rob_waiting_stores.begin(); it != m_rob_waiting_stores.end(); ++it)
+      if (findEntryBySequenceNumber(*it)->addressReady > now)
+         return *it;
+   return INVALID_SEQNR;
+}
+
 boost::tuple<uint64_t,SubsecondTime> RobTimer::simulate(const std::vector<DynamicMicroOp*>& insts)
 {
    uint64_t totalInsnExec = 0;
@@ -503,6 +550,15 @@ SubsecondTime RobTimer::doDispatch(SubsecondTime **cpiComponent)
          entry->ready = std::max(entry->ready, (now + 1ul).getElapsedTime());
          next_event = std::min(next_event, entry->ready);
 
+         if (entry->ready != SubsecondTime::MaxTime())
+            m_rob_ready.insert(uop.getSequenceNumber());
+         else
+         {
+            m_rob_waiting.insert(uop.getSequenceNumber());
+            if (uop.getMicroOp()->isStore())
+               m_rob_waiting_stores.insert(uop.getSequenceNumber());
+         }
+
          #ifdef DEBUG_PERCYCLE
             std::cout<<"DISPATCH "<<entry->uop->getMicroOp()->toShortString()<<std::endl;
          #endif
@@ -564,9 +620,8 @@ SubsecondTime RobTimer::doDispatch(SubsecondTime **cpiComponent)
       return std::min(frontend_stalled_until, next_event);
 }
 
-void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
+void RobTimer::issueInstruction(RobEntry *entry, SubsecondTime &next_event)
 {
-   RobEntry *entry = &rob[idx];
    DynamicMicroOp &uop = *entry->uop;
 
    if ((uop.getMicroOp()->isLoad() || uop.getMicroOp()->isStore())
@@ -630,6 +685,11 @@ void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
    entry->done = cycle_done;
    next_event = std::min(next_event, entry->done);
 
+   m_rob_ready.erase(uop.getSequenceNumber());
+   setDoneTime(uop.getSequenceNumber(), entry->done);
+   if (m_mlp_histogram && uop.getMicroOp()->isLoad())
+      m_outstanding_loads_list.push_back(entry);
+
    --m_rs_entries_used;
 
    #ifdef DEBUG_PERCYCLE
@@ -650,6 +710,13 @@ void RobTimer::issueInstruction(uint64_t idx, SubsecondTime &next_event)
       {
          depEntry->ready = depEntry->readyMax;
          //std::cout<<"    ready @ "<<depEntry->ready<<std::endl;
+
+         // Uops that are not dispatched yet are put in the right set by doDispatch
+         if (m_rob_waiting.erase(depEntry->uop->getSequenceNumber()))
+         {
+            m_rob_waiting_stores.erase(depEntry->uop->getSequenceNumber());
+            m_rob_ready.insert(depEntry->uop->getSequenceNumber());
+         }
       }
 
       // For stores, check if their address has been produced
@@ -703,17 +770,39 @@ SubsecondTime RobTimer::doIssue()
    if (m_rob_contention)
       m_rob_contention->initCycle(now);
 
-   for(uint64_t i = 0; i < m_num_in_rob; ++i)
-   {
-      RobEntry *entry = &rob.at(i);
-      DynamicMicroOp *uop = entry->uop;
+   if (m_num_in_rob == 0)
+      return next_event;
+
+   // Rather than walking the whole window, only visit uops with all dependencies resolved, in program order.
+   // Uops that are still waiting for a producer can never issue, but they do clear head_of_queue and
+   // have_unresolved_store for younger uops, and stop an in-order core. Uops that were already issued
+   // only contribute their done time to next_event, for all uops up to where the walk stops.
+   uint64_t first_seq = rob.front().uop->getSequenceNumber();
+   uint64_t last_seq = first_seq + m_num_in_rob - 1;
 
+   // issueInstruction removes the current uop from m_rob_ready and may add younger ones, so look up the next one every time
+   uint64_t seq = 0;
+   for(std::set<uint64_t>::iterator it = m_rob_ready.begin(); it != m_rob_ready.end(); it = m_rob_ready.upper_bound(seq))
+   {
+      seq = *it;
 
-      if (entry->done != SubsecondTime::MaxTime())
+      // Waiting uops can become ready while we walk, so look these up every time
+      uint64_t first_waiting = m_rob_waiting.empty() ? INVALID_SEQNR : *m_rob_waiting.begin();
+      if (first_waiting < seq)
       {
-         next_event = std::min(next_event, entry->done);
-         continue;                     // already done
+         head_of_queue = false;
+         if (inorder)
+         {
+            // In-order: only issue from head of the ROB
+            last_seq = first_waiting;
+            break;
+         }
       }
+      if (m_no_address_disambiguation && !have_unresolved_store && getFirstUnresolvedStore() < seq)
+         have_unresolved_store = true;
+
+      RobEntry *entry = findEntryBySequenceNumber(seq);
+      DynamicMicroOp *uop = entry->uop;
 
       next_event = std::min(next_event, entry->ready);
 
@@ -733,7 +822,10 @@ SubsecondTime RobTimer::doIssue()
          if (head_of_queue && last_store_done <= now)
             canIssue = true;
          else
+         {
+            last_seq = seq;
             break;
+         }
       }
 
       else if (uop->getMicroOp()->isMemBarrier())
@@ -770,7 +862,7 @@ SubsecondTime RobTimer::doIssue()
       if (canIssue)
       {
          num_issued++;
-         issueInstruction(i, next_event);
+         issueInstruction(entry, next_event);
 
          // Calculate memory-level parallelism (MLP) for long-latency loads (but ignore overlapped misses)
          if (uop->getMicroOp()->isLoad() && uop->isLongLatencyLoad() && uop->getDCacheHitWhere() != HitWhere::L1_OWN)
@@ -808,23 +900,35 @@ SubsecondTime RobTimer::doIssue()
             have_unresolved_store = true;
 
          if (inorder)
+         {
             // In-order: only issue from head of the ROB
+            last_seq = seq;
             break;
+         }
       }
 
 
       if (m_rob_contention)
       {
          if (m_rob_contention->noMore())
+         {
+            last_seq = seq;
             break;
+         }
       }
       else
       {
          if (num_issued == dispatchWidth)
+         {
+            last_seq = seq;
             break;
+         }
       }
    }
 
+   // Issued uops (including the ones we just issued) will complete at their done time
+   next_event = std::min(next_event, getMinDoneTime(first_seq, last_seq));
+
    return next_event;
 }
 
@@ -852,6 +956,7 @@ SubsecondTime RobTimer::doCommit(uint64_t& instructionsExecuted)
       if (entry->uop->isLast())
          instructionsExecuted++;
 
+      setDoneTime(entry->uop->getSequenceNumber(), SubsecondTime::MaxTime());
       entry->free();
       rob.pop();
       m_num_in_rob--;
@@ -956,15 +1061,20 @@ void RobTimer::countOutstandingMemop(SubsecondTime time)
 {
    UInt64 counts[HitWhere::NUM_HITWHERES] = {0}, total = 0;
 
-   for(unsigned int i = 0; i < m_num_in_rob; ++i)
+   // Only look at issued loads. Once a load is done it can be dropped from the list for good, as time only moves forward.
+   // This happens before its ROB entry can be reused: we are called at the end of every cycle, commit only takes done uops.
+   size_t num_outstanding = 0;
+   for(size_t i = 0; i < m_outstanding_loads_list.size(); ++i)
    {
-      RobEntry *e = &rob.at(i);
-      if (e->done != SubsecondTime::MaxTime() && e->done > now && e->uop->getMicroOp()->isLoad())
+      RobEntry *e = m_outstanding_loads_list[i];
+      if (e->done > now)
       {
          ++counts[e->uop->getDCacheHitWhere()];
          ++total;
+         m_outstanding_loads_list[num_outstanding++] = e;
       }
    }
+   m_outstanding_loads_list.resize(num_outstanding);
 
    for(unsigned int h = 0; h < HitWhere::NUM_HITWHERES; ++h)
       if (counts[h] > 0)
@@ -10,6 +10,7 @@
 #include "stats.h"
 
 #include <deque>
+#include <set>
 
 class RobTimer
 {
@@ -60,6 +61,17 @@ private:
    Rob rob;
    uint64_t m_num_in_rob;
    uint64_t m_rs_entries_used;
+
+   // Dispatched but not yet issued uops, by sequence number. doIssue only walks the ready ones,
+   // uops move from waiting to ready when issueInstruction resolves their last dependency.
+   std::set<uint64_t> m_rob_ready;        // All dependencies resolved (ready != MaxTime)
+   std::set<uint64_t> m_rob_waiting;      // Still waiting for a producer to issue
+   std::set<uint64_t> m_rob_waiting_stores; // Subset of m_rob_waiting that are stores
+   // Min-tree over the done times of issued, not yet committed uops, indexed by sequence number modulo the ROB size
+   const uint64_t m_done_tree_size;
+   std::vector<SubsecondTime> m_done_tree;
+   // Issued loads, for the MLP histogram
+   std::vector<RobEntry*> m_outstanding_loads_list;
    RobContention *m_rob_contention;
 
    ComponentTime now;
@@ -136,6 +148,9 @@ private:
    std::vector<SubsecondTime> m_outstandingLoadsAll;
 
    RobEntry *findEntryBySequenceNumber(UInt64 sequenceNumber);
+   void setDoneTime(UInt64 sequenceNumber, SubsecondTime done);
+   SubsecondTime getMinDoneTime(UInt64 first, UInt64 last);
+   uint64_t getFirstUnresolvedStore();
    SubsecondTime* findCpiComponent();
    void countOutstandingMemop(SubsecondTime time);
    void printRob();
@@ -145,7 +160,7 @@ private:
    SubsecondTime doIssue();
    SubsecondTime doCommit(uint64_t& instructionsExecuted);
 
-   void issueInstruction(uint64_t idx, SubsecondTime &next_event);
+   void issueInstruction(RobEntry *entry, SubsecondTime &next_event);
 
 public:
 
@@ -5,6 +5,7 @@
 #include "queue_model_history_list.h"
 #include "queue_model_contention.h"
 #include "queue_model_windowed_mg1.h"
+#include "queue_model_windowed_mg1_ring.h"
 #include "log.h"
 #include "config.hpp"
 using namespace std;
@@ -33,6 +34,10 @@ QueueModel::create(String name, UInt32 id, String model_type, SubsecondTime min_
    {
       return new QueueModelWindowedMG1(name, id);
    }
+   else if (model_type == "windowed_mg1_ring")
+   {
+      return new QueueModelWindowedMG1Ring(name, id);
+   }
    else
    {
       LOG_PRINT_ERROR("Unrecognized Queue Model Type(%s)", model_type.c_str());
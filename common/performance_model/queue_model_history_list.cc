@@ -12,7 +12,8 @@ QueueModelHistoryList::QueueModelHistoryList(String name, UInt32 id, SubsecondTi
    m_utilized_time(SubsecondTime::Zero()),
    m_total_queue_delay(SubsecondTime::Zero()),
    m_total_requests(0),
-   m_total_requests_using_analytical_model(0)
+   m_total_requests_using_analytical_model(0),
+   m_total_intervals_dropped(0)
 {
 //cout << "%%%%%%%%%%%%%%%%%%%%%%%%%%% min_processing_time: " << to_string(min_processing_time.getNS()) << endl;
    // history_list queuing model does not play nice with the interval core model:
@@ -42,10 +43,11 @@ QueueModelHistoryList::QueueModelHistoryList(String name, UInt32 id, SubsecondTi
    m_max_free_interval_list_size = max_list_size;
    m_average_delay = MovingAverage<SubsecondTime>::createAvgType(MovingAverage<SubsecondTime>::ARITHMETIC_MEAN, max_list_size);
    SubsecondTime max_simulation_time = SubsecondTime::FS() << 63;
-   m_free_interval_list.push_back(std::pair<const SubsecondTime,SubsecondTime>(SubsecondTime::Zero(), max_simulation_time));
+   m_free_interval_list.insert(std::pair<const SubsecondTime,SubsecondTime>(SubsecondTime::Zero(), max_simulation_time));
 
    registerStatsMetric(name, id, "num-requests", &m_total_requests);
    registerStatsMetric(name, id, "num-requests-analytical", &m_total_requests_using_analytical_model);
+   registerStatsMetric(name, id, "num-intervals-dropped", &m_total_intervals_dropped);
    registerStatsMetric(name, id, "total-time-used", &m_utilized_time);
    registerStatsMetric(name, id, "total-queue-delay", &m_total_queue_delay);
 }
@@ -67,7 +69,7 @@ QueueModelHistoryList::computeQueueDelay(SubsecondTime pkt_time, SubsecondTime p
    // Check if it is an old packet
    // If yes, use analytical model
    // If not, use the history list based queue model
-   std::pair<SubsecondTime,SubsecondTime> oldest_interval = m_free_interval_list.front();
+   std::pair<SubsecondTime,SubsecondTime> oldest_interval = *m_free_interval_list.begin();
 //cout << "+++++++++++++ m_analytical_model_enabled: " << to_string(m_analytical_model_enabled) << endl;
 //cout << "oldest_interval: " << to_string(oldest_interval.first.getNS()) << " to " << to_string(oldest_interval.second.getNS()) << endl;
    if (m_analytical_model_enabled && ((pkt_time + processing_time) <= oldest_interval.first))
@@ -95,7 +97,7 @@ QueueModelHistoryList::computeQueueDelay(SubsecondTime pkt_time, SubsecondTime p
 float
 QueueModelHistoryList::getQueueUtilization()
 {
-   std::pair<SubsecondTime,SubsecondTime> newest_interval = m_free_interval_list.back();
+   std::pair<SubsecondTime,SubsecondTime> newest_interval = *m_free_interval_list.rbegin();
    SubsecondTime total_time = newest_interval.first;
 
    if (total_time == SubsecondTime::Zero())
@@ -156,8 +158,18 @@ QueueModelHistoryList::computeUsingHistoryList(SubsecondTime pkt_time, Subsecond
 
    SubsecondTime queue_delay = SubsecondTime::MaxTime();
 
-   FreeIntervalList::iterator curr_it;
-   for (curr_it = m_free_interval_list.begin(); curr_it != m_free_interval_list.end(); curr_it ++)
+   // Intervals are sorted and disjoint, so only two candidates can match: the interval starting at or before
+   // pkt_time (which the packet may fit in), and otherwise the first interval starting after pkt_time.
+   FreeIntervalList::iterator curr_it = m_free_interval_list.upper_bound(pkt_time);
+   if (curr_it != m_free_interval_list.begin())
+   {
+      FreeIntervalList::iterator prev_it = curr_it;
+      --prev_it;
+      if ((pkt_time + processing_time) <= prev_it->second)
+         curr_it = prev_it;
+   }
+
+   if (curr_it != m_free_interval_list.end())
    {
       std::pair<SubsecondTime,SubsecondTime> interval = (*curr_it);
 //cout << "interval.first: " << to_string(interval.first.getNS()) << " interval.second: " << to_string(interval.second.getNS()) << endl;
@@ -165,18 +177,17 @@ QueueModelHistoryList::computeUsingHistoryList(SubsecondTime pkt_time, Subsecond
       {
          queue_delay = SubsecondTime::Zero();
          // Adjust the data structure accordingly
-         curr_it = m_free_interval_list.erase(curr_it);
+         m_free_interval_list.erase(curr_it);
 // [LINGXI]: looks like it's creating many 'fragments': a new request is fitted into a slot, if the slot is large enough, it will accomondate multiple such requests, otherwise the whole slot is dedicated
 // to the request
 	 if ((pkt_time - interval.first) >= m_min_processing_time)
          {
-            m_free_interval_list.insert(curr_it, std::pair<SubsecondTime,SubsecondTime>(interval.first, pkt_time));
+            m_free_interval_list.insert(std::pair<SubsecondTime,SubsecondTime>(interval.first, pkt_time));
          }
          if ((interval.second - (pkt_time + processing_time)) >= m_min_processing_time)
          {
-            m_free_interval_list.insert(curr_it, std::pair<SubsecondTime,SubsecondTime>(pkt_time + processing_time, interval.second));
+            m_free_interval_list.insert(std::pair<SubsecondTime,SubsecondTime>(pkt_time + processing_time, interval.second));
          }
-         break;
       }
       // WH: The request comes before this free part, but doesn't fit. It doesn't make sense to me to
       //     demand a fit and move this request down even further. In reality, this request would have most
@@ -189,12 +200,11 @@ QueueModelHistoryList::computeUsingHistoryList(SubsecondTime pkt_time, Subsecond
       {
          queue_delay = interval.first - pkt_time;
          // Adjust the data structure accordingly
-         curr_it = m_free_interval_list.erase(curr_it);
+         m_free_interval_list.erase(curr_it);
          if ((interval.second - (interval.first + processing_time)) >= m_min_processing_time)
          {
-            m_free_interval_list.insert(curr_it, std::pair<SubsecondTime,SubsecondTime>(interval.first + processing_time, interval.second));
+            m_free_interval_list.insert(std::pair<SubsecondTime,SubsecondTime>(interval.first + processing_time, interval.second));
          }
-         break;
       }
    }
 
@@ -203,6 +213,7 @@ QueueModelHistoryList::computeUsingHistoryList(SubsecondTime pkt_time, Subsecond
    if (m_free_interval_list.size() > m_max_free_interval_list_size)
    {
       m_free_interval_list.erase(m_free_interval_list.begin());
+      m_total_intervals_dropped ++;
    }
 
    LOG_PRINT("HistoryList: pkt_time(%s), processing_time(%s), queue_delay(%s)", itostr(pkt_time).c_str(), itostr(processing_time).c_str(), itostr(queue_delay).c_str());
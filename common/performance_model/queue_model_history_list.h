@@ -1,7 +1,7 @@
 #ifndef __QUEUE_MODEL_HISTORY_LIST_H__
 #define __QUEUE_MODEL_HISTORY_LIST_H__
 
-#include <list>
+#include <map>
 
 #include "queue_model.h"
 #include "fixed_types.h"
@@ -11,7 +11,9 @@ class QueueModelHistoryList : public QueueModel
 {
 public:
 	// [LINGXI]
-   typedef std::list<std::pair<SubsecondTime,SubsecondTime> > FreeIntervalList;
+   // Free intervals, keyed by their start time and mapping to their end time. Intervals never overlap,
+   // so a balanced tree gives O(log n) lookup of the interval a packet falls into.
+   typedef std::map<SubsecondTime,SubsecondTime> FreeIntervalList;
 
    QueueModelHistoryList(String name, UInt32 id, SubsecondTime min_processing_time);
    ~QueueModelHistoryList();
@@ -39,6 +41,7 @@ private:
    // Performance Counters
    UInt64 m_total_requests;
    UInt64 m_total_requests_using_analytical_model;
+   UInt64 m_total_intervals_dropped; // free intervals discarded because the list exceeded max_list_size
 
    void updateQueueUtilization(SubsecondTime processing_time);
    void updateAverageDelay(SubsecondTime queue_delay);
@@ -0,0 +1,125 @@
+#include "queue_model_windowed_mg1_ring.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "log.h"
+#include "stats.h"
+
+#include <algorithm>
+
+// Requests can be up to 10 window sizes ahead of the window start (see computeQueueDelay), plus one bucket
+// that may have passed since the last window advance
+static const UInt64 RING_WINDOWS = 11;
+
+QueueModelWindowedMG1Ring::QueueModelWindowedMG1Ring(String name, UInt32 id)
+   : m_window_size(SubsecondTime::NS(Sim()->getCfg()->getInt("queue_model/windowed_mg1/window_size")))
+   , m_bucket_size(std::max(UInt64(1), m_window_size.getPS() / Sim()->getCfg()->getInt("queue_model/windowed_mg1_ring/buckets_per_window")))
+   , m_total_requests(0)
+   , m_total_utilized_time(SubsecondTime::Zero())
+   , m_total_queue_delay(SubsecondTime::Zero())
+   , m_first_bucket(0)
+   , m_last_advance_bucket(0)
+   , m_num_arrivals(0)
+   , m_service_time_sum(0)
+   , m_service_time_sum2(0)
+{
+   Bucket empty = { 0, 0, 0 };
+   m_buckets.resize(RING_WINDOWS * (m_window_size.getPS() / m_bucket_size) + 1, empty);
+
+   registerStatsMetric(name, id, "num-requests", &m_total_requests);
+   registerStatsMetric(name, id, "total-time-used", &m_total_utilized_time);
+   registerStatsMetric(name, id, "total-queue-delay", &m_total_queue_delay);
+}
+
+QueueModelWindowedMG1Ring::~QueueModelWindowedMG1Ring()
+{}
+
+SubsecondTime
+QueueModelWindowedMG1Ring::computeQueueDelay(SubsecondTime pkt_time, SubsecondTime processing_time, core_id_t requester)
+{
+   SubsecondTime t_queue = SubsecondTime::Zero();
+
+   // Advance the window based on the global (barrier) time, as this guarantees the earliest time any thread may be at.
+   // Use a backup value of 10 window sizes before the current request to avoid excessive memory usage in case something fishy is going on.
+   // Only do this once per bucket: the window cannot move by less than a bucket anyway.
+   UInt64 bucket = pkt_time.getPS() / m_bucket_size;
+   if (bucket > m_last_advance_bucket)
+   {
+      m_last_advance_bucket = bucket;
+      SubsecondTime global_time = Sim()->getClockSkewMinimizationServer()->getGlobalTime();
+      SubsecondTime earliest_time = SubsecondTime::Zero();
+      if (global_time > m_window_size)
+         earliest_time = global_time - m_window_size;
+      if (pkt_time > 10*m_window_size)
+         earliest_time = std::max(earliest_time, pkt_time - 10*m_window_size);
+      removeItems(earliest_time);
+   }
+
+   if (m_num_arrivals > 1)
+   {
+      double utilization = (double)m_service_time_sum / m_window_size.getPS();
+      double arrival_rate = (double)m_num_arrivals / m_window_size.getPS();
+
+      double service_time_Es2 = m_service_time_sum2 / m_num_arrivals;
+
+      // If requesters do not throttle based on returned latency, it's their problem, not ours
+      if (utilization > .99)
+         utilization = .99;
+
+      t_queue = SubsecondTime::PS(arrival_rate * service_time_Es2 / (2 * (1. - utilization)));
+
+      // Our memory is limited in time to m_window_size. It would be strange to return more latency than that.
+      if (t_queue > m_window_size)
+         t_queue = m_window_size;
+   }
+
+   addItem(pkt_time, processing_time);
+
+   m_total_requests++;
+   m_total_utilized_time += processing_time;
+   m_total_queue_delay += t_queue;
+
+   return t_queue;
+}
+
+void
+QueueModelWindowedMG1Ring::addItem(SubsecondTime pkt_time, SubsecondTime service_time)
+{
+   UInt64 bucket = pkt_time.getPS() / m_bucket_size;
+
+   // Requests that already fell out of the window would be removed by the next window advance, don't bother adding them
+   if (bucket < m_first_bucket)
+      return;
+   // Should not happen given how the window is advanced, but never write outside of the ring
+   if (bucket >= m_first_bucket + m_buckets.size())
+      bucket = m_first_bucket + m_buckets.size() - 1;
+
+   Bucket &entry = m_buckets[bucket % m_buckets.size()];
+   UInt64 service_time_ps = service_time.getPS();
+   entry.num_arrivals ++;
+   entry.service_time_sum += service_time_ps;
+   entry.service_time_sum2 += service_time_ps * service_time_ps;
+
+   m_num_arrivals ++;
+   m_service_time_sum += service_time_ps;
+   m_service_time_sum2 += service_time_ps * service_time_ps;
+}
+
+void
+QueueModelWindowedMG1Ring::removeItems(SubsecondTime earliest_time)
+{
+   // Drop all buckets that end before earliest_time
+   UInt64 first_bucket = earliest_time.getPS() / m_bucket_size;
+   if (first_bucket <= m_first_bucket)
+      return;
+
+   UInt64 last_bucket = std::min(first_bucket, m_first_bucket + m_buckets.size());
+   for(UInt64 bucket = m_first_bucket; bucket < last_bucket; ++bucket)
+   {
+      Bucket &entry = m_buckets[bucket % m_buckets.size()];
+      m_num_arrivals -= entry.num_arrivals;
+      m_service_time_sum -= entry.service_time_sum;
+      m_service_time_sum2 -= entry.service_time_sum2;
+      entry.num_arrivals = entry.service_time_sum = entry.service_time_sum2 = 0;
+   }
+   m_first_bucket = first_bucket;
+}
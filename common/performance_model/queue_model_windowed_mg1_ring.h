@@ -0,0 +1,48 @@
+#ifndef __QUEUE_MODEL_WINDOWED_MG1_RING_H__
+#define __QUEUE_MODEL_WINDOWED_MG1_RING_H__
+
+#include "queue_model.h"
+#include "fixed_types.h"
+
+#include <vector>
+
+// Same M/G/1 estimate as QueueModelWindowedMG1, but arrivals are aggregated into fixed-width time buckets
+// kept in a ring with running sums, rather than stored individually in a multimap.
+// Adding a request and advancing the window are O(1) (amortized) and never allocate.
+// The window is advanced at bucket granularity (window_size / buckets_per_window), and only when a request
+// enters a new bucket, which also limits how often the global time needs to be read.
+class QueueModelWindowedMG1Ring : public QueueModel
+{
+public:
+   QueueModelWindowedMG1Ring(String name, UInt32 id);
+   ~QueueModelWindowedMG1Ring();
+
+   SubsecondTime computeQueueDelay(SubsecondTime pkt_time, SubsecondTime processing_time, core_id_t requester = INVALID_CORE_ID);
+
+private:
+   struct Bucket
+   {
+      UInt64 num_arrivals;
+      UInt64 service_time_sum; // In ps
+      UInt64 service_time_sum2; // In ps^2
+   };
+
+   const SubsecondTime m_window_size;
+   const UInt64 m_bucket_size; // In ps
+
+   UInt64 m_total_requests;
+   SubsecondTime m_total_utilized_time;
+   SubsecondTime m_total_queue_delay;
+
+   std::vector<Bucket> m_buckets;
+   UInt64 m_first_bucket; // Absolute index (time / m_bucket_size) of the oldest bucket in the ring
+   UInt64 m_last_advance_bucket; // Absolute bucket index of the request that last advanced the window
+   UInt64 m_num_arrivals;
+   UInt64 m_service_time_sum; // In ps
+   UInt64 m_service_time_sum2; // In ps^2
+
+   void addItem(SubsecondTime pkt_time, SubsecondTime service_time);
+   void removeItems(SubsecondTime earliest_time);
+};
+
+#endif /* __QUEUE_MODEL_WINDOWED_MG1_RING_H__ */
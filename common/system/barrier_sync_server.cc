@@ -12,6 +12,7 @@
 #include "stats.h"
 #include "config.hpp"
 #include "circular_log.h"
+#include "network.h"
 
 #include <algorithm>
 
@@ -20,19 +21,33 @@ BarrierSyncServer::BarrierSyncServer()
    , m_barrier_acquire_list(Sim()->getConfig()->getApplicationCores(), false)
    , m_core_cond(Sim()->getConfig()->getApplicationCores(), NULL)
    , m_core_group(Sim()->getConfig()->getApplicationCores(), INVALID_CORE_ID)
+   , m_group_members(Sim()->getConfig()->getApplicationCores())
    , m_core_thread(Sim()->getConfig()->getApplicationCores(), INVALID_THREAD_ID)
+   , m_blocker(0)
    , m_global_time(SubsecondTime::Zero())
    , m_fastforward(false)
+   , m_last_remote_packets(0)
+   , m_last_adapt_time(SubsecondTime::Zero())
+   , m_num_widened(0)
+   , m_num_narrowed(0)
    , m_disable(false)
 {
    try
    {
       m_barrier_interval = SubsecondTime::NS() * (UInt64) Sim()->getCfg()->getInt("clock_skew_minimization/barrier/quantum");
+      m_adaptive = Sim()->getCfg()->getBool("clock_skew_minimization/barrier/adaptive/enabled");
+      m_max_interval = SubsecondTime::NS() * (UInt64) Sim()->getCfg()->getInt("clock_skew_minimization/barrier/adaptive/max_quantum");
+      m_low_traffic = Sim()->getCfg()->getFloat("clock_skew_minimization/barrier/adaptive/low_traffic");
+      m_high_traffic = Sim()->getCfg()->getFloat("clock_skew_minimization/barrier/adaptive/high_traffic");
    }
    catch(...)
    {
-      LOG_PRINT_ERROR("Error Reading 'clock_skew_minimization/barrier/quantum' from the config file");
+      LOG_PRINT_ERROR("Error Reading 'clock_skew_minimization/barrier' parameters from the config file");
    }
+   m_min_interval = m_barrier_interval;
+   if (m_adaptive)
+      LOG_ASSERT_ERROR(m_max_interval >= m_min_interval && m_low_traffic <= m_high_traffic,
+                       "Invalid adaptive barrier configuration: need max_quantum >= quantum and low_traffic <= high_traffic");
 
    for(core_id_t core_id = 0; core_id < (core_id_t)Sim()->getConfig()->getApplicationCores(); ++core_id)
       m_core_cond[core_id] = new ConditionVariable();
@@ -45,6 +60,12 @@ BarrierSyncServer::BarrierSyncServer()
    Sim()->getHooksManager()->registerHook(HookType::HOOK_THREAD_MIGRATE, BarrierSyncServer::hookThreadMigrate, (UInt64)this, HooksManager::ORDER_NOTIFY_POST);
 
    registerStatsMetric("barrier", 0, "global_time", &m_global_time);
+   registerStatsMetric("barrier", 0, "quantum", &m_barrier_interval);
+   if (m_adaptive)
+   {
+      registerStatsMetric("barrier", 0, "quantum-widened", &m_num_widened);
+      registerStatsMetric("barrier", 0, "quantum-narrowed", &m_num_narrowed);
+   }
 }
 
 BarrierSyncServer::~BarrierSyncServer()
@@ -90,6 +111,7 @@ BarrierSyncServer::synchronize(core_id_t core_id, SubsecondTime time)
 
    m_local_clock_list[master_core_id] = time;
    m_barrier_acquire_list[master_core_id] = true;
+   m_acquired_cores.push_back(master_core_id);
    m_core_thread[master_core_id] = thread_me;
 
    bool mustWait = true;
@@ -134,9 +156,10 @@ BarrierSyncServer::threadMigrate(HooksManager::ThreadMigrate *argument)
 void
 BarrierSyncServer::releaseThread(thread_id_t thread_id)
 {
-   for(core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+   for(std::vector<core_id_t>::iterator it = m_acquired_cores.begin(); it != m_acquired_cores.end(); ++it)
    {
-      if (m_barrier_acquire_list[core_id] && m_core_thread[core_id] == thread_id)
+      core_id_t core_id = *it;
+      if (m_core_thread[core_id] == thread_id)
       {
          // Make sure thread is released on next barrierRelease()
          m_local_clock_list[core_id] = SubsecondTime::Zero();
@@ -170,13 +193,10 @@ BarrierSyncServer::isCoreRunning(core_id_t core_id, bool siblings)
 
    if (siblings && !m_fastforward)
    {
-      for (core_id_t sibling_core_id = 0; sibling_core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); sibling_core_id++)
+      for (std::vector<core_id_t>::iterator it = m_group_members[core_id].begin(); it != m_group_members[core_id].end(); ++it)
       {
-         if (m_core_group[sibling_core_id] == core_id)
-         {
-            if (isCoreRunning(sibling_core_id, false))
-               return true;
-         }
+         if (isCoreRunning(*it, false))
+            return true;
       }
    }
 
@@ -189,16 +209,37 @@ BarrierSyncServer::advance()
    barrierRelease(INVALID_THREAD_ID, true);
 }
 
+bool
+BarrierSyncServer::isBlocking(core_id_t core_id)
+{
+   // A core holds up the barrier when it is running but hasn't checked in yet (fastforward),
+   // or when it is a running group master that has not advanced up to the barrier time (detailed)
+   if (m_fastforward)
+      return !m_barrier_acquire_list[core_id] && isCoreRunning(core_id);
+   else if (m_core_group[core_id] != INVALID_CORE_ID)
+      return false;
+   else
+      return isCoreRunning(core_id) && m_local_clock_list[core_id] < m_next_barrier_time;
+}
+
 bool
 BarrierSyncServer::isBarrierReached()
 {
-   bool single_core_barrier_reached = false;
+   // This is called on every barrier entry. Most of the time the core that held up the barrier
+   // on the previous call still does, check it first rather than scanning all cores again.
+   if (isBlocking(m_blocker))
+      return false;
 
    // Check if all cores have reached the barrier
    // All least one core must have (sync_time > m_next_barrier_time)
-   for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+   // Start scanning at the previous blocker: cores before it were checked recently,
+   // this way the search for the next blocker does not keep revisiting the same cores.
+   bool single_core_barrier_reached = false;
+   core_id_t num_cores = Sim()->getConfig()->getApplicationCores();
+   for (core_id_t i = 0; i < num_cores; i++)
    {
-      // In fastforward mode, it's enough that a core is waiting. In detailed mode, it needs to have advanced up to the predefined barrier time
+      core_id_t core_id = (m_blocker + i) % num_cores;
+      // Same conditions as isBlocking(), but also look for cores that have reached the barrier
       if (m_fastforward)
       {
          if (m_barrier_acquire_list[core_id])
@@ -208,21 +249,19 @@ BarrierSyncServer::isBarrierReached()
          }
          else if (isCoreRunning(core_id))
          {
-            // Core is running but hasn't checked in yet. Wait for it to sync.
+            m_blocker = core_id;
             return false;
          }
       }
       else if (m_core_group[core_id] != INVALID_CORE_ID)
       {
-         // Only consider group masters
          continue;
       }
       else if (isCoreRunning(core_id))
       {
          if (m_local_clock_list[core_id] < m_next_barrier_time)
          {
-            // Core running on this core has not reached the barrier
-            // Wait for it to sync
+            m_blocker = core_id;
             return false;
          }
          else
@@ -250,11 +289,12 @@ BarrierSyncServer::barrierRelease(thread_id_t caller_id, bool continue_until_rel
 
    if (m_fastforward)
    {
-      for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+      // Cores not in the barrier were released with a time below m_next_barrier_time, they cannot be ahead of it
+      for (std::vector<core_id_t>::iterator it = m_acquired_cores.begin(); it != m_acquired_cores.end(); ++it)
       {
          // In fast-forward mode, skip over (potentially very many) timeslots
-         if (m_local_clock_list[core_id] > m_next_barrier_time)
-            m_next_barrier_time = m_local_clock_list[core_id];
+         if (m_local_clock_list[*it] > m_next_barrier_time)
+            m_next_barrier_time = m_local_clock_list[*it];
       }
    }
 
@@ -264,6 +304,7 @@ BarrierSyncServer::barrierRelease(thread_id_t caller_id, bool continue_until_rel
 
    bool core_resumed = false;
    bool must_wait = true;
+   bool adapted = false;
    while (!core_resumed)
    {
       m_global_time = m_next_barrier_time;
@@ -283,44 +324,102 @@ BarrierSyncServer::barrierRelease(thread_id_t caller_id, bool continue_until_rel
       if (m_disable)
          return false;
 
-      m_next_barrier_time += m_barrier_interval;
+      if (m_adaptive && !m_fastforward)
+      {
+         // Consider traffic once per release, not for every quantum skipped while no core could be resumed
+         if (!adapted)
+         {
+            adaptBarrierInterval();
+            adapted = true;
+         }
+         // Keep barriers at multiples of the (possibly changed) interval, which is where BarrierSyncClient expects them
+         m_next_barrier_time = (m_next_barrier_time / m_barrier_interval) * m_barrier_interval + m_barrier_interval;
+      }
+      else
+         m_next_barrier_time += m_barrier_interval;
       LOG_PRINT("m_next_barrier_time updated to (%s)", itostr(m_next_barrier_time).c_str());
 
-      for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+      // Only visit cores that are in the barrier: release those whose quantum ended, cores that are ahead stay
+      std::vector<core_id_t>::iterator keep = m_acquired_cores.begin();
+      for (std::vector<core_id_t>::iterator it = m_acquired_cores.begin(); it != m_acquired_cores.end(); ++it)
       {
+         core_id_t core_id = *it;
          if (m_local_clock_list[core_id] < m_next_barrier_time)
          {
-            // Check if this core was running. If yes, release that core
-            if (m_barrier_acquire_list[core_id] == true)
+            //Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+            //LOG_ASSERT_ERROR(core->getState() == Core::RUNNING || core->getState() == Core::INITIALIZING, "(%i) has acquired barrier, local_clock(%s), m_next_barrier_time(%s), but not initializing or running", core_id, itostr(m_local_clock_list[core_id]).c_str(), itostr(m_next_barrier_time).c_str());
+
+            m_barrier_acquire_list[core_id] = false;
+            core_resumed = true;
+
+            if (m_core_thread[core_id] == caller_id)
+               must_wait = false;
+            else
             {
-               //Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
-               //LOG_ASSERT_ERROR(core->getState() == Core::RUNNING || core->getState() == Core::INITIALIZING, "(%i) has acquired barrier, local_clock(%s), m_next_barrier_time(%s), but not initializing or running", core_id, itostr(m_local_clock_list[core_id]).c_str(), itostr(m_next_barrier_time).c_str());
-
-               m_barrier_acquire_list[core_id] = false;
-               core_resumed = true;
-
-               if (m_core_thread[core_id] == caller_id)
-                  must_wait = false;
-               else
-               {
-                  Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
-                  core->getPerformanceModel()->barrierExit();
-                  m_to_release.push_back(core_id);
-               }
+               Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+               core->getPerformanceModel()->barrierExit();
+               m_to_release.push_back(core_id);
             }
          }
+         else
+         {
+            *keep++ = core_id;
+         }
       }
+      m_acquired_cores.erase(keep, m_acquired_cores.end());
    }
 
    // To avoid overwhelming the OS scheduler, we only release N threads at a time (N ~= host cores).
    // Once a thread is done (stops executing because it completed the next barrier quantum, or due to thread stall),
    // one more thread is released so we always have at most N running threads.
+   // Sort first, m_acquired_cores is in arrival order while the shuffle should only depend on the random state
+   std::sort(m_to_release.begin(), m_to_release.end());
    std::random_shuffle(m_to_release.begin(), m_to_release.end());
    doRelease(m_fastforward ? -1 : Sim()->getConfig()->getNumHostCores());
 
    return must_wait;
 }
 
+void
+BarrierSyncServer::adaptBarrierInterval()
+{
+   if (m_global_time <= m_last_adapt_time)
+      return;
+
+   UInt64 remote_packets = 0;
+   for (core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+      remote_packets += Sim()->getCoreManager()->getCoreFromID(core_id)->getNetwork()->getNumRemotePackets();
+
+   double traffic = double(remote_packets - m_last_remote_packets)
+                  / Sim()->getConfig()->getApplicationCores()
+                  / ((m_global_time - m_last_adapt_time).getNS() / 1000.);
+
+   m_last_remote_packets = remote_packets;
+   m_last_adapt_time = m_global_time;
+
+   SubsecondTime interval = m_barrier_interval;
+   if (traffic > m_high_traffic)
+   {
+      // On a burst of communication, go straight back to the accurate quantum
+      interval = m_min_interval;
+   }
+   else if (traffic < m_low_traffic)
+   {
+      // While cores hardly interact, widen the quantum gradually
+      interval = std::min(2 * m_barrier_interval, m_max_interval);
+   }
+
+   if (interval > m_barrier_interval)
+      ++m_num_widened;
+   else if (interval < m_barrier_interval)
+      ++m_num_narrowed;
+   else
+      return;
+
+   CLOG("barrier", "Quantum %" PRId64 "ns > %" PRId64 "ns (%.3f packets/core/us)", m_barrier_interval.getNS(), interval.getNS(), traffic);
+   m_barrier_interval = interval;
+}
+
 void
 BarrierSyncServer::doRelease(int n)
 {
@@ -338,18 +437,18 @@ void
 BarrierSyncServer::abortBarrier()
 {
    CLOG("barrier", "Abort");
-   for(core_id_t core_id = 0; core_id < (core_id_t) Sim()->getConfig()->getApplicationCores(); core_id++)
+   // Release all cores that are in the barrier
+   std::sort(m_acquired_cores.begin(), m_acquired_cores.end());
+   for(std::vector<core_id_t>::iterator it = m_acquired_cores.begin(); it != m_acquired_cores.end(); ++it)
    {
-      // Check if this core was running. If yes, release that core
-      if (m_barrier_acquire_list[core_id] == true)
-      {
-         m_barrier_acquire_list[core_id] = false;
+      core_id_t core_id = *it;
+      m_barrier_acquire_list[core_id] = false;
 
-         Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
-         core->getPerformanceModel()->barrierExit();
-         m_core_cond[core_id]->signal();
-      }
+      Core *core = Sim()->getCoreManager()->getCoreFromID(core_id);
+      core->getPerformanceModel()->barrierExit();
+      m_core_cond[core_id]->signal();
    }
+   m_acquired_cores.clear();
 }
 
 void
@@ -366,6 +465,14 @@ BarrierSyncServer::setGroup(core_id_t core_id, core_id_t master_core_id)
    if (master_core_id != INVALID_CORE_ID)
       LOG_ASSERT_ERROR(m_barrier_acquire_list[core_id] == false, "Core(%d) is in the barrier, cannot set participate to false", core_id);
 
+   if (m_core_group[core_id] != INVALID_CORE_ID)
+   {
+      std::vector<core_id_t> &members = m_group_members[m_core_group[core_id]];
+      members.erase(std::find(members.begin(), members.end(), core_id));
+   }
+   if (master_core_id != INVALID_CORE_ID)
+      m_group_members[master_core_id].push_back(core_id);
+
    m_core_group[core_id] = master_core_id;
 }
 
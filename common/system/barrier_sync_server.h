@@ -19,18 +19,34 @@ class BarrierSyncServer : public ClockSkewMinimizationServer
       std::vector<ConditionVariable*> m_core_cond;
       std::vector<core_id_t> m_to_release;
       std::vector<core_id_t> m_core_group;
+      std::vector<std::vector<core_id_t> > m_group_members; // Inverse of m_core_group: SMT siblings of each group master
       std::vector<thread_id_t> m_core_thread;
+      std::vector<core_id_t> m_acquired_cores; // Cores with m_barrier_acquire_list set, so release does not need to visit all cores
+      core_id_t m_blocker; // Last core found holding up the barrier, checked first on the next arrival
       SubsecondTime m_global_time;
       bool m_fastforward;
+
+      // Adaptive quantum: widen the barrier interval while cores hardly communicate, narrow it on bursts
+      bool m_adaptive;
+      SubsecondTime m_min_interval;
+      SubsecondTime m_max_interval;
+      double m_low_traffic;  // Inter-core packets per core per microsecond
+      double m_high_traffic;
+      UInt64 m_last_remote_packets;
+      SubsecondTime m_last_adapt_time;
+      UInt64 m_num_widened;
+      UInt64 m_num_narrowed;
       volatile bool m_disable;
 
       bool isBarrierReached(void);
+      bool isBlocking(core_id_t core_id);
       bool barrierRelease(thread_id_t thread_id = INVALID_THREAD_ID, bool continue_until_release = false);
       void abortBarrier(void);
       bool isCoreRunning(core_id_t core_id, bool siblings = true);
       void releaseThread(thread_id_t thread_id);
       void signal();
       void doRelease(int n);
+      void adaptBarrierInterval(void);
 
       static SInt64 hookThreadExit(UInt64 object, UInt64 argument) {
          ((BarrierSyncServer*)object)->threadExit((HooksManager::ThreadTime*)argument); return 0;
@@ -0,0 +1,151 @@
+#include "checkpoint_manager.h"
+#include "simulator.h"
+#include "config.h"
+#include "config.hpp"
+#include "hooks_manager.h"
+#include "magic_server.h"
+#include "itostr.h"
+
+#include <cstdio>
+
+static_assert(sizeof(CheckpointHeader) == 16, "CheckpointHeader must not contain padding");
+
+CheckpointManager::CheckpointManager()
+   : m_save_filename(Sim()->getCfg()->getString("checkpoint/save"))
+   , m_restore_filename(Sim()->getCfg()->getString("checkpoint/restore"))
+   , m_save_marker(Sim()->getCfg()->getInt("checkpoint/save_marker"))
+   , m_save_instructions(Sim()->getCfg()->getInt("checkpoint/save_instructions"))
+   , m_saved(false)
+{
+   if (!m_restore_filename.empty())
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_SIM_START, hookSimStart, (UInt64)this);
+
+   if (!m_save_filename.empty())
+   {
+      LOG_ASSERT_ERROR(m_save_marker || m_save_instructions, "checkpoint/save requires either checkpoint/save_marker or checkpoint/save_instructions");
+      if (m_save_marker)
+         Sim()->getHooksManager()->registerHook(HookType::HOOK_MAGIC_MARKER, hookMagicMarker, (UInt64)this);
+      if (m_save_instructions)
+         Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC_INS, hookPeriodicIns, (UInt64)this);
+   }
+}
+
+void
+CheckpointManager::registerObject(String objectName, UInt32 index, Checkpointable *object)
+{
+   String name = objectName + "[" + itostr(index) + "]";
+   LOG_ASSERT_ERROR(m_objects.count(name) == 0, "Checkpoint object %s registered twice", name.c_str());
+   m_objects[name] = object;
+}
+
+void
+CheckpointManager::save(String filename)
+{
+   FILE *fp = fopen(filename.c_str(), "wb");
+   LOG_ASSERT_ERROR(fp != NULL, "Cannot open checkpoint file %s for writing", filename.c_str());
+
+   CheckpointHeader header = { MAGIC, VERSION, (UInt32)m_objects.size(), 0 };
+   fwrite(&header, sizeof(header), 1, fp);
+
+   std::vector<char> buffer;
+   for(Objects::iterator it = m_objects.begin(); it != m_objects.end(); ++it)
+   {
+      buffer.clear();
+      CheckpointWriter writer(buffer);
+      it->second->saveCheckpoint(writer);
+
+      UInt32 name_length = it->first.size();
+      UInt64 size = buffer.size();
+      fwrite(&name_length, sizeof(name_length), 1, fp);
+      fwrite(it->first.c_str(), name_length, 1, fp);
+      fwrite(&size, sizeof(size), 1, fp);
+      fwrite(buffer.data(), size, 1, fp);
+   }
+
+   LOG_ASSERT_ERROR(ferror(fp) == 0, "Error writing checkpoint file %s", filename.c_str());
+   fclose(fp);
+
+   printf("[SNIPER] Saved checkpoint with %zu sections to %s\n", m_objects.size(), filename.c_str());
+}
+
+void
+CheckpointManager::restore(String filename)
+{
+   FILE *fp = fopen(filename.c_str(), "rb");
+   LOG_ASSERT_ERROR(fp != NULL, "Cannot open checkpoint file %s", filename.c_str());
+
+   CheckpointHeader header;
+   LOG_ASSERT_ERROR(fread(&header, sizeof(header), 1, fp) == 1 && header.magic == MAGIC,
+      "%s is not a checkpoint file", filename.c_str());
+   LOG_ASSERT_ERROR(header.version == VERSION,
+      "Checkpoint file %s has version %u, this simulator supports version %u", filename.c_str(), header.version, VERSION);
+
+   UInt32 num_restored = 0;
+   std::vector<char> buffer;
+   for(UInt32 i = 0; i < header.num_sections; ++i)
+   {
+      UInt32 name_length;
+      UInt64 size;
+      LOG_ASSERT_ERROR(fread(&name_length, sizeof(name_length), 1, fp) == 1, "Checkpoint file %s is truncated", filename.c_str());
+      String name(name_length, '\0');
+      LOG_ASSERT_ERROR(fread(&name[0], name_length, 1, fp) == 1 || name_length == 0, "Checkpoint file %s is truncated", filename.c_str());
+      LOG_ASSERT_ERROR(fread(&size, sizeof(size), 1, fp) == 1, "Checkpoint file %s is truncated", filename.c_str());
+      buffer.resize(size);
+      LOG_ASSERT_ERROR(fread(buffer.data(), size, 1, fp) == 1 || size == 0, "Checkpoint file %s is truncated", filename.c_str());
+
+      Objects::iterator it = m_objects.find(name);
+      if (it == m_objects.end())
+      {
+         LOG_PRINT_WARNING("Checkpoint section %s does not exist in this configuration, skipping", name.c_str());
+         continue;
+      }
+
+      CheckpointReader reader(name, buffer);
+      if (it->second->restoreCheckpoint(reader) && reader.done())
+         ++num_restored;
+      else
+         LOG_PRINT_WARNING("Checkpoint section %s does not match this configuration, its state was not (fully) restored", name.c_str());
+   }
+   fclose(fp);
+
+   if (num_restored != m_objects.size())
+      LOG_PRINT_WARNING("Restored %u out of %zu objects from checkpoint %s", num_restored, m_objects.size(), filename.c_str());
+   printf("[SNIPER] Restored checkpoint with %u sections from %s\n", num_restored, filename.c_str());
+}
+
+void
+CheckpointManager::saveOnce()
+{
+   // Other application threads are not stopped, so a marker should be placed where they are quiescent
+   // (e.g. right after a barrier) for the checkpoint to be consistent
+   // The hooks can fire on several threads at once, only the first one saves
+   if (__sync_bool_compare_and_swap(&m_saved, false, true))
+      save(Sim()->getConfig()->formatOutputFileName(m_save_filename));
+}
+
+SInt64
+CheckpointManager::hookSimStart(UInt64 self, UInt64)
+{
+   CheckpointManager *manager = (CheckpointManager*)self;
+   manager->restore(manager->m_restore_filename);
+   return 0;
+}
+
+SInt64
+CheckpointManager::hookMagicMarker(UInt64 self, UInt64 arg)
+{
+   CheckpointManager *manager = (CheckpointManager*)self;
+   MagicServer::MagicMarkerType *marker = (MagicServer::MagicMarkerType*)arg;
+   if (marker->arg0 == manager->m_save_marker)
+      manager->saveOnce();
+   return 0;
+}
+
+SInt64
+CheckpointManager::hookPeriodicIns(UInt64 self, UInt64 icount)
+{
+   CheckpointManager *manager = (CheckpointManager*)self;
+   if (icount >= manager->m_save_instructions)
+      manager->saveOnce();
+   return 0;
+}
@@ -0,0 +1,141 @@
+#ifndef __CHECKPOINT_MANAGER_H
+#define __CHECKPOINT_MANAGER_H
+
+#include "fixed_types.h"
+#include "log.h"
+
+#include <map>
+#include <vector>
+#include <cstring>
+
+// Checkpoints of warmed microarchitectural state (cache and TLB contents, directories, branch predictors,
+// prefetchers, DRAM open rows), so a long warmup only has to be simulated once.
+//
+// A checkpoint is saved to checkpoint/save (in the output directory) when the application issues
+// SimMarker(save_marker, *) or once the global instruction count reaches save_instructions, and restored
+// from checkpoint/restore before the application starts. Only the contents of these structures are saved:
+// cache line data, in-flight requests and timing state (queues, busy times) are not.
+//
+// File layout (host byte order): a CheckpointHeader, then for each section a UInt32 name length, the name,
+// a UInt64 payload size and the payload. Each section holds one object, named "<objectName>[<index>]".
+
+struct CheckpointHeader
+{
+   UInt32 magic;
+   UInt32 version;
+   UInt32 num_sections;
+   UInt32 reserved;
+};
+
+class CheckpointWriter
+{
+   public:
+      CheckpointWriter(std::vector<char> &buffer) : m_buffer(buffer) {}
+
+      void write(const void *data, UInt64 size)
+      {
+         m_buffer.insert(m_buffer.end(), (const char*)data, (const char*)data + size);
+      }
+      template <typename T> void write(const T &value) { write(&value, sizeof(T)); }
+
+      // Arrays are stored with their length, so readArray can detect a different geometry
+      template <typename T> void writeArray(const T *data, UInt64 count)
+      {
+         write(count);
+         write(data, count * sizeof(T));
+      }
+      template <typename T> void writeArray(const std::vector<T> &data) { writeArray(data.data(), data.size()); }
+      void writeArray(const std::vector<bool> &data)
+      {
+         write(UInt64(data.size()));
+         for(std::vector<bool>::const_iterator it = data.begin(); it != data.end(); ++it)
+            write(UInt8(*it));
+      }
+
+   private:
+      std::vector<char> &m_buffer;
+};
+
+class CheckpointReader
+{
+   public:
+      CheckpointReader(String name, const std::vector<char> &buffer) : m_name(name), m_buffer(buffer), m_offset(0) {}
+
+      void read(void *data, UInt64 size)
+      {
+         LOG_ASSERT_ERROR(m_offset + size <= m_buffer.size(), "Checkpoint section %s is truncated", m_name.c_str());
+         memcpy(data, &m_buffer[m_offset], size);
+         m_offset += size;
+      }
+      template <typename T> void read(T &value) { read(&value, sizeof(T)); }
+      template <typename T> T read() { T value; read(&value, sizeof(T)); return value; }
+
+      // Returns false, without reading the data, when the stored array does not have count elements
+      template <typename T> bool readArray(T *data, UInt64 count)
+      {
+         if (read<UInt64>() != count)
+            return false;
+         read(data, count * sizeof(T));
+         return true;
+      }
+      template <typename T> bool readArray(std::vector<T> &data) { return readArray(data.data(), data.size()); }
+      bool readArray(std::vector<bool> &data)
+      {
+         if (read<UInt64>() != data.size())
+            return false;
+         for(std::vector<bool>::iterator it = data.begin(); it != data.end(); ++it)
+            *it = read<UInt8>();
+         return true;
+      }
+
+      bool done() const { return m_offset == m_buffer.size(); }
+
+   private:
+      const String m_name;
+      const std::vector<char> &m_buffer;
+      UInt64 m_offset;
+};
+
+class Checkpointable
+{
+   public:
+      virtual ~Checkpointable() {}
+
+      virtual void saveCheckpoint(CheckpointWriter &writer) = 0;
+      // Return false when the checkpoint was taken with a different configuration of this object
+      virtual bool restoreCheckpoint(CheckpointReader &reader) = 0;
+};
+
+class CheckpointManager
+{
+   public:
+      static const UInt32 MAGIC = 0x31504353; // "SCP1"
+      static const UInt32 VERSION = 1;
+
+      CheckpointManager();
+
+      // Objects register when they are constructed, and must live until the end of the simulation
+      void registerObject(String objectName, UInt32 index, Checkpointable *object);
+
+      void save(String filename);
+      void restore(String filename);
+
+   private:
+      // Ordered by name, so checkpoints of the same configuration have their sections in the same order
+      typedef std::map<String, Checkpointable*> Objects;
+      Objects m_objects;
+
+      const String m_save_filename;
+      const String m_restore_filename;
+      const UInt64 m_save_marker;
+      const UInt64 m_save_instructions;
+      bool m_saved;
+
+      void saveOnce();
+
+      static SInt64 hookSimStart(UInt64 self, UInt64);
+      static SInt64 hookMagicMarker(UInt64 self, UInt64 arg);
+      static SInt64 hookPeriodicIns(UInt64 self, UInt64 icount);
+};
+
+#endif // __CHECKPOINT_MANAGER_H
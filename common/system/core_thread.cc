@@ -8,6 +8,7 @@
 #include "sim_api.h"
 
 #include <unistd.h>
+#include <sched.h>
 
 CoreThread::CoreThread()
    : m_thread(NULL)
@@ -40,9 +41,14 @@ void CoreThread::run()
                          (void *)&cont);
 
    PerformanceModel *prfmdl = Sim()->getCoreManager()->getCurrentCore()->getPerformanceModel();
+   UInt32 idle_iterations = 0;
    while (cont) {
-      prfmdl->iterate();
-      usleep(1000); // Reduce system load while there's nothing to do (outside ROI)
+      if (prfmdl->iterate())
+         idle_iterations = 0;
+      else if (++idle_iterations < 1000)
+         sched_yield(); // Application thread may just be decoding its next batch of instructions
+      else
+         usleep(1000); // Reduce system load while there's nothing to do (outside ROI)
    }
 
    Sim()->getSimThreadManager()->simThreadExitCallback();
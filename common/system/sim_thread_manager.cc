@@ -4,9 +4,13 @@
 #include "log.h"
 #include "config.h"
 #include "simulator.h"
+#include "config.hpp"
 
 SimThreadManager::SimThreadManager()
-   : m_active_threads(0)
+   : m_sim_threads(NULL)
+   , m_core_threads(NULL)
+   , m_perf_model_own_thread(Sim()->getCfg()->getBool("perf_model/core/own_thread"))
+   , m_active_threads(0)
 {
 }
 
@@ -19,26 +23,20 @@ SimThreadManager::~SimThreadManager()
 void SimThreadManager::spawnSimThreads()
 {
    UInt32 num_cores = Config::getSingleton()->getTotalCores();
-   #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-   __attribute__((unused)) UInt32 num_sim_threads = 2 * num_cores;
-   #else
-   __attribute__((unused)) UInt32 num_sim_threads = num_cores;
-   #endif
+   __attribute__((unused)) UInt32 num_sim_threads = m_perf_model_own_thread ? 2 * num_cores : num_cores;
 
    LOG_PRINT("Starting %d threads.", num_sim_threads);
 
    m_sim_threads = new SimThread [num_cores];
-   #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-   m_core_threads = new CoreThread [num_cores];
-   #endif
+   if (m_perf_model_own_thread)
+      m_core_threads = new CoreThread [num_cores];
 
    for (UInt32 i = 0; i < num_cores; i++)
    {
       LOG_PRINT("Starting thread %i", i);
       m_sim_threads[i].spawn();
-      #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-      m_core_threads[i].spawn();
-      #endif
+      if (m_perf_model_own_thread)
+         m_core_threads[i].spawn();
    }
 
 // PIN_SpawnInternalThread doesn't schedule its threads until after PIN_StartProgram
@@ -61,11 +59,12 @@ void SimThreadManager::quitSimThreads()
 
    for (core_id_t core_id = 0; core_id < (core_id_t)Config::getSingleton()->getTotalCores(); core_id++)
    {
-      #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-      // First kill core thread (needs network thread to be alive to deliver the message)
-      pkt2.receiver = core_id;
-      global_node->send(core_id, &pkt2, pkt2.bufferSize());
-      #endif
+      if (m_perf_model_own_thread)
+      {
+         // First kill core thread (needs network thread to be alive to deliver the message)
+         pkt2.receiver = core_id;
+         global_node->send(core_id, &pkt2, pkt2.bufferSize());
+      }
 
       // Now kill network thread
       pkt1.receiver = core_id;
@@ -80,9 +79,8 @@ void SimThreadManager::quitSimThreads()
    Transport::getSingleton()->barrier();
 
    delete [] m_sim_threads;
-   #ifdef ENABLE_PERF_MODEL_OWN_THREAD
-   delete [] m_core_threads;
-   #endif
+   if (m_core_threads)
+      delete [] m_core_threads;
 
    LOG_PRINT("All threads have exited.");
 }
@@ -19,6 +19,8 @@ public:
 private:
    SimThread *m_sim_threads;
    CoreThread *m_core_threads;
+   // Run each core's performance model on its own CoreThread (perf_model/core/own_thread)
+   const bool m_perf_model_own_thread;
 
    Lock m_active_threads_lock;
    UInt32 m_active_threads;
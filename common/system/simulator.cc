@@ -17,6 +17,7 @@
 #include "trace_manager.h"
 #include "dvfs_manager.h"
 #include "hooks_manager.h"
+#include "checkpoint_manager.h"
 #include "sampling_manager.h"
 #include "fault_injection.h"
 #include "routine_tracer.h"
@@ -118,6 +119,7 @@ Simulator::Simulator()
    , m_trace_manager(NULL)
    , m_dvfs_manager(NULL)
    , m_hooks_manager(NULL)
+   , m_checkpoint_manager(NULL)
    , m_sampling_manager(NULL)
    , m_faultinjection_manager(NULL)
    , m_rtn_tracer(NULL)
@@ -137,6 +139,7 @@ void Simulator::start()
    createDecoder();
    
    m_hooks_manager = new HooksManager();
+   m_checkpoint_manager = new CheckpointManager();
    m_syscall_server = new SyscallServer();
    m_sync_server = new SyncServer();
    m_magic_server = new MagicServer();
@@ -216,6 +219,8 @@ Simulator::~Simulator()
    }
 
    m_stats_manager->recordStats("stop");
+   // Scripts may read the database at the end of simulation
+   m_stats_manager->flushStats();
    m_hooks_manager->callHooks(HookType::HOOK_SIM_END, 0);
 
    TotalTimer::reports();
@@ -257,6 +262,7 @@ Simulator::~Simulator()
    delete m_magic_server;              m_magic_server = NULL;
    delete m_sync_server;               m_sync_server = NULL;
    delete m_syscall_server;            m_syscall_server = NULL;
+   delete m_checkpoint_manager;        m_checkpoint_manager = NULL;
    delete m_hooks_manager;             m_hooks_manager = NULL;
    delete m_tags_manager;              m_tags_manager = NULL;
    delete m_transport;                 m_transport = NULL;
@@ -20,6 +20,7 @@ class ThreadManager;
 class ThreadStatsManager;
 class SimThreadManager;
 class HooksManager;
+class CheckpointManager;
 class ClockSkewMinimizationManager;
 class FastForwardPerformanceManager;
 class TraceManager;
@@ -64,8 +65,12 @@ public:
    ThreadStatsManager *getThreadStatsManager() { return m_thread_stats_manager; }
    DvfsManager *getDvfsManager() { return m_dvfs_manager; }
    HooksManager *getHooksManager() { return m_hooks_manager; }
+   CheckpointManager *getCheckpointManager() { return m_checkpoint_manager; }
    SamplingManager *getSamplingManager() { return m_sampling_manager; }
    FaultinjectionManager *getFaultinjectionManager() { return m_faultinjection_manager; }
+   // Functional line data is only consumed by fault injection. Without it, caches and DRAM keep no data arrays
+   // and coherence messages do not carry their data payloads (they are still modeled with their full length)
+   bool isTimingOnlyMemory() { return m_faultinjection_manager == NULL; }
    TraceManager *getTraceManager() { return m_trace_manager; }
    TagsManager *getTagsManager() { return m_tags_manager; }
    RoutineTracer *getRoutineTracer() { return m_rtn_tracer; }
@@ -102,6 +107,7 @@ private:
    TraceManager *m_trace_manager;
    DvfsManager *m_dvfs_manager;
    HooksManager *m_hooks_manager;
+   CheckpointManager *m_checkpoint_manager;
    SamplingManager *m_sampling_manager;
    FaultinjectionManager *m_faultinjection_manager;
    RoutineTracer *m_rtn_tracer;
@@ -0,0 +1,157 @@
+#include "decode_cache.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "stats.h"
+#include "log.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static const UInt32 DECODE_CACHE_MAGIC = 0x53444331; // "SDC1"
+
+DecodeCache::DecodeCache()
+   : m_filename(Sim()->getCfg()->getString("traceinput/decode_cache/file"))
+   , m_num_loaded(0)
+   , m_num_decodes(0)
+   , m_num_shared_hits(0)
+   , m_num_decodes_saved(0)
+{
+   registerStatsMetric("decode_cache", 0, "loaded", &m_num_loaded);
+   registerStatsMetric("decode_cache", 0, "decodes", &m_num_decodes);
+   registerStatsMetric("decode_cache", 0, "shared-hits", &m_num_shared_hits);
+
+   if (m_filename != "")
+      load();
+}
+
+DecodeCache::~DecodeCache()
+{
+   for(UInt32 bin = 0; bin < NUM_BINS; ++bin)
+   {
+      for(Bin::iterator it = m_bins[bin].begin(); it != m_bins[bin].end(); ++it)
+      {
+         for(std::vector<Entry*>::iterator jt = it->second.begin(); jt != it->second.end(); ++jt)
+         {
+            delete (*jt)->inst;
+            delete *jt;
+         }
+      }
+   }
+}
+
+const dl::DecodedInst*
+DecodeCache::lookup(int isa, UInt64 address, const UInt8 *code, UInt32 size, bool count)
+{
+   LOG_ASSERT_ERROR(size <= MAX_INST_SIZE, "Instruction at %lx is too long (%u bytes)", address, size);
+
+   UInt32 bin = getBin(address);
+   ScopedLock sl(m_locks[bin]);
+
+   std::vector<Entry*> &entries = m_bins[bin][address];
+   for(std::vector<Entry*>::iterator it = entries.begin(); it != entries.end(); ++it)
+   {
+      Entry *entry = *it;
+      if (entry->isa == isa && entry->size == size && memcmp(entry->code, code, size) == 0)
+      {
+         // Counters are shared by all bins, which are locked separately
+         if (count)
+            __sync_fetch_and_add(&m_num_shared_hits, 1);
+         return entry->inst;
+      }
+   }
+
+   // Decoding happens under the bin lock, so other threads wanting the same instruction
+   // wait for this decode rather than doing their own
+   Entry *entry = new Entry();
+   entry->address = address;
+   entry->isa = isa;
+   entry->size = size;
+   memcpy(entry->code, code, size);
+   entry->inst = m_factory.CreateInstruction(Sim()->getDecoder(), entry->code, size, address);
+   Sim()->getDecoder()->decode(entry->inst, (dl::dl_isa)isa);
+   entries.push_back(entry);
+
+   if (count)
+      __sync_fetch_and_add(&m_num_decodes, 1);
+   return entry->inst;
+}
+
+void
+DecodeCache::load()
+{
+   FILE *fp = fopen(m_filename.c_str(), "rb");
+   if (!fp)
+      return;
+
+   UInt32 header[3];
+   if (fread(header, sizeof(header), 1, fp) != 1 || header[0] != DECODE_CACHE_MAGIC)
+   {
+      LOG_PRINT_WARNING("Ignoring decode cache %s: not a decode cache file", m_filename.c_str());
+      fclose(fp);
+      return;
+   }
+   if (header[1] != (UInt32)Sim()->getDecoder()->get_arch() || header[2] != (UInt32)Sim()->getDecoder()->get_mode())
+   {
+      LOG_PRINT_WARNING("Ignoring decode cache %s: recorded for a different architecture", m_filename.c_str());
+      fclose(fp);
+      return;
+   }
+
+   UInt64 address;
+   UInt8 isa_size[2], code[MAX_INST_SIZE];
+   while(fread(&address, sizeof(address), 1, fp) == 1
+      && fread(isa_size, sizeof(isa_size), 1, fp) == 1
+      && isa_size[1] <= MAX_INST_SIZE
+      && fread(code, isa_size[1], 1, fp) == 1)
+   {
+      lookup(isa_size[0], address, code, isa_size[1], false);
+      ++m_num_loaded;
+   }
+
+   fclose(fp);
+}
+
+void
+DecodeCache::save()
+{
+   // Nothing new since the file was loaded or last written
+   if (m_filename == "" || m_num_decodes == m_num_decodes_saved)
+      return;
+   m_num_decodes_saved = m_num_decodes;
+
+   // Write to a temporary file first, so concurrent runs sharing the same decode cache
+   // never see (or leave behind) a partially written file
+   String tmpname = m_filename + ".tmp" + itostr(getpid());
+   FILE *fp = fopen(tmpname.c_str(), "wb");
+   if (!fp)
+   {
+      LOG_PRINT_WARNING("Cannot write decode cache %s", tmpname.c_str());
+      return;
+   }
+
+   UInt32 header[3] = { DECODE_CACHE_MAGIC, (UInt32)Sim()->getDecoder()->get_arch(), (UInt32)Sim()->getDecoder()->get_mode() };
+   fwrite(header, sizeof(header), 1, fp);
+
+   for(UInt32 bin = 0; bin < NUM_BINS; ++bin)
+   {
+      // Threads that did not stop yet may still be adding entries
+      ScopedLock sl(m_locks[bin]);
+      for(Bin::iterator it = m_bins[bin].begin(); it != m_bins[bin].end(); ++it)
+      {
+         for(std::vector<Entry*>::iterator jt = it->second.begin(); jt != it->second.end(); ++jt)
+         {
+            Entry *entry = *jt;
+            UInt8 isa_size[2] = { entry->isa, entry->size };
+            fwrite(&entry->address, sizeof(entry->address), 1, fp);
+            fwrite(isa_size, sizeof(isa_size), 1, fp);
+            fwrite(entry->code, entry->size, 1, fp);
+         }
+      }
+   }
+
+   if (fclose(fp) == 0)
+      rename(tmpname.c_str(), m_filename.c_str());
+   else
+      unlink(tmpname.c_str());
+}
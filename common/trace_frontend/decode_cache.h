@@ -0,0 +1,67 @@
+#ifndef __DECODE_CACHE_H
+#define __DECODE_CACHE_H
+
+#include "fixed_types.h"
+#include "lock.h"
+
+#include <decoder.h>
+
+#include <unordered_map>
+#include <vector>
+
+// Process-wide cache of decoded static instructions, shared by all TraceThreads.
+// Entries are keyed by (ISA, address, instruction bytes) so different code mapped at the same address
+// (multiple applications, self-modifying code) gets its own entry. Entries are never evicted or changed
+// once inserted, so the DecodedInst pointers handed out stay valid until the cache is destroyed.
+// TraceThreads keep their own per-address map in front of this one, so the shared cache is only
+// consulted (and its locks only taken) the first time a thread sees a static instruction.
+//
+// With traceinput/decode_cache/file set, the instruction bytes of all cached entries are written out
+// at the end of every run (see TraceManager::run) and decoded up front when the file exists at startup.
+// Decoded state itself cannot be stored: the decoder's structures point into the decoder library's tables.
+
+class DecodeCache
+{
+   private:
+      static const UInt32 MAX_INST_SIZE = 16;
+
+      struct Entry
+      {
+         UInt64 address;
+         UInt8 isa;
+         UInt8 size;
+         UInt8 code[MAX_INST_SIZE]; // The decoded instruction points here, so entries must not move
+         dl::DecodedInst *inst;
+      };
+
+      // A single address can map to multiple entries, but almost never does
+      typedef std::unordered_map<UInt64, std::vector<Entry*> > Bin;
+
+      static const UInt32 NUM_BINS = 64;
+      Bin m_bins[NUM_BINS];
+      Lock m_locks[NUM_BINS];
+
+      dl::DecoderFactory m_factory;
+      const String m_filename;
+
+      UInt64 m_num_loaded;
+      UInt64 m_num_decodes;
+      UInt64 m_num_shared_hits;
+      UInt64 m_num_decodes_saved;
+
+      static UInt32 getBin(UInt64 address) { return (address ^ (address >> 12)) % NUM_BINS; }
+      const dl::DecodedInst* lookup(int isa, UInt64 address, const UInt8 *code, UInt32 size, bool count);
+
+      void load();
+
+   public:
+      DecodeCache();
+      ~DecodeCache();
+
+      void save();
+
+      const dl::DecodedInst* get(int isa, UInt64 address, const UInt8 *code, UInt32 size)
+      { return lookup(isa, address, code, size, true); }
+};
+
+#endif // __DECODE_CACHE_H
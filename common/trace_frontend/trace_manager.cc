@@ -1,5 +1,6 @@
 #include "trace_manager.h"
 #include "trace_thread.h"
+#include "decode_cache.h"
 #include "simulator.h"
 #include "thread_manager.h"
 #include "hooks_manager.h"
@@ -25,6 +26,7 @@ TraceManager::TraceManager()
    , m_app_info(m_num_apps)
    , m_tracefiles(m_num_apps)
    , m_responsefiles(m_num_apps)
+   , m_decode_cache(new DecodeCache())
 {
    setupTraceFiles(0);
 }
@@ -236,6 +238,7 @@ void TraceManager::cleanup()
 TraceManager::~TraceManager()
 {
    cleanup();
+   delete m_decode_cache;
 }
 
 void TraceManager::start()
@@ -280,6 +283,7 @@ void TraceManager::run()
 {
    start();
    wait();
+   m_decode_cache->save();
 }
 
 UInt64 TraceManager::getProgressExpect()
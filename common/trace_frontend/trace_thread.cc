@@ -1,5 +1,6 @@
 #include "trace_thread.h"
 #include "trace_manager.h"
+#include "decode_cache.h"
 #include "simulator.h"
 #include "core_manager.h"
 #include "thread_manager.h"
@@ -66,6 +67,7 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
    //   xed_initialized = true;
    //}
 
+   m_trace.setAsync(Sim()->getCfg()->getBool("traceinput/async_read"));
    m_trace.setHandleInstructionCountFunc(TraceThread::__handleInstructionCountFunc, this);
    m_trace.setHandleCacheOnlyFunc(TraceThread::__handleCacheOnlyFunc, this);
    if (Sim()->getCfg()->getBool("traceinput/mirror_output"))
@@ -106,10 +108,6 @@ TraceThread::~TraceThread()
       unlink(m_tracefile.c_str());
       unlink(m_responsefile.c_str());
    }
-   for(std::unordered_map<IntPtr, const dl::DecodedInst *>::iterator i = m_decoder_cache.begin() ; i != m_decoder_cache.end() ; ++i)
-   {
-      delete (*i).second;
-   }
 }
 
 UInt64 TraceThread::va2pa(UInt64 va, bool *noMapping)
@@ -220,6 +218,7 @@ uint64_t TraceThread::handleSyscallFunc(uint16_t syscall_number, const uint8_t *
    }
 
    LOG_ASSERT_ERROR(m_thread->getCore(), "Cannot execute while not on a core");
+   drainPerformanceModel();
    uint64_t ret = 0;
 
    switch(syscall_number)
@@ -258,12 +257,14 @@ int32_t TraceThread::handleForkFunc()
 
 int32_t TraceThread::handleJoinFunc(int32_t join_thread_id)
 {
+   drainPerformanceModel();
    Sim()->getThreadManager()->joinThread(m_thread->getId(), join_thread_id);
    return 0;
 }
 
 uint64_t TraceThread::handleMagicFunc(uint64_t a, uint64_t b, uint64_t c)
 {
+   drainPerformanceModel();
    return handleMagicInstruction(m_thread->getId(), a, b, c);
 }
 
@@ -294,6 +295,7 @@ bool TraceThread::handleEmuFunc(Sift::EmuType type, Sift::EmuRequest &req, Sift:
    }
 
    LOG_ASSERT_ERROR(m_thread->getCore(), "Cannot execute while not on a core");
+   drainPerformanceModel();
 
    switch(type)
    {
@@ -388,9 +390,18 @@ void TraceThread::handleRoutineAnnounceFunc(uint64_t eip, const char *name, cons
 SubsecondTime TraceThread::getCurrentTime() const
 {
    LOG_ASSERT_ERROR(m_thread->getCore() != NULL, "Cannot get time while not on a core");
+   m_thread->getCore()->getPerformanceModel()->drain();
    return m_thread->getCore()->getPerformanceModel()->getElapsedTime();
 }
 
+void TraceThread::drainPerformanceModel()
+{
+   // With perf_model/core/own_thread, our instructions may still be queued for the core's timing thread.
+   // Let it catch up before doing anything that looks at (or changes) simulated time or memory.
+   if (m_thread->getCore())
+      m_thread->getCore()->getPerformanceModel()->drain();
+}
+
 Instruction* TraceThread::decode(Sift::Instruction &inst)
 {
 
@@ -530,10 +541,8 @@ void TraceThread::handleCacheOnlyFunc(uint8_t icount, Sift::CacheOnlyType type,
 
 const dl::DecodedInst* TraceThread::staticDecode(Sift::Instruction &inst)
 {
-   dl::DecodedInst *dec_inst = m_factory->CreateInstruction(Sim()->getDecoder(), inst.sinst->data, 
-                                                            inst.sinst->size, inst.sinst->addr);
-   Sim()->getDecoder()->decode(dec_inst, (dl::dl_isa)inst.isa);
-   return dec_inst;
+   // Other threads running the same code have likely decoded this instruction already
+   return Sim()->getTraceManager()->getDecodeCache()->get(inst.isa, inst.sinst->addr, inst.sinst->data, inst.sinst->size);
 }
 
 void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruction &next_inst, Core *core, bool do_icache_warmup, UInt64 icache_warmup_addr, UInt64 icache_warmup_size)
@@ -778,6 +787,13 @@ void TraceThread::run()
    m_trace.initStream();
    m_trace_has_pa = m_trace.getTraceHasPhysicalAddresses();
 
+   UInt64 seek = Sim()->getCfg()->getInt("traceinput/seek");
+   if (seek)
+   {
+      bool success = m_trace.Seek(seek);
+      LOG_ASSERT_ERROR(success, "Could not seek to instruction %ld in trace %s", seek, m_tracefile.c_str());
+   }
+
    if (m_thread->getCore() == NULL)
    {
       // We didn't get scheduled on startup, wait here
@@ -850,7 +866,7 @@ void TraceThread::run()
 
 
       // We may have been rescheduled to a different core
-      // by prfmdl->iterate (in handleInstructionDetailed),
+      // by prfmdl->iterate (in handleInstructionDetailed, or the CoreThread with perf_model/core/own_thread),
       // or core->countInstructions (when using a fast-forward performance model)
       SubsecondTime time = prfmdl->getElapsedTime();
       if (m_thread->reschedule(time, core))
@@ -868,6 +884,7 @@ void TraceThread::run()
 
    printf("[TRACE:%u] -- %s --\n", m_thread->getId(), m_stop ? "STOP" : "DONE");
 
+   prfmdl->drain();
    SubsecondTime time_end = prfmdl->getElapsedTime();
 
    Sim()->getThreadManager()->onThreadExit(m_thread->getId());
@@ -63,7 +63,7 @@ class TraceThread : public Runnable
       //std::unordered_map<IntPtr, const xed_decoded_inst_t *> m_decoder_cache;  // TODO convert to DecoderLib
       //static bool xed_initialized;  // TODO convert to DecoderLib
       //xed_state_t m_xed_state_init;  // TODO convert to DecoderLib
-      std::unordered_map<IntPtr, const dl::DecodedInst *> m_decoder_cache;  // TODO convert to DecoderLib
+      std::unordered_map<IntPtr, const dl::DecodedInst *> m_decoder_cache;  // Front-end to TraceManager's shared DecodeCache, which owns the entries
       UInt64 m_bbv_base;
       UInt64 m_bbv_count;
       UInt64 m_bbv_last;
@@ -121,11 +121,11 @@ class TraceThread : public Runnable
       //void addDetailedMemoryInfo(DynamicInstruction *dynins, Sift::Instruction &inst, const xed_decoded_inst_t &xed_inst, uint32_t mem_idx, Operand::Direction op_type, bool is_pretetch, PerformanceModel *prfmdl);
       void addDetailedMemoryInfo(DynamicInstruction *dynins, Sift::Instruction &inst, const dl::DecodedInst &decoded_inst, uint32_t mem_idx, Operand::Direction op_type, bool is_pretetch, PerformanceModel *prfmdl);
       void unblock();
+      void drainPerformanceModel();
 
       SubsecondTime getCurrentTime() const;
       
       //static dl::Decoder *m_decoder;
-      dl::DecoderFactory *m_factory;  // we need a factory here to be able to create instructions of any kind
       //const xed_decoded_inst_t* staticDecode(Sift::Instruction &inst);
       const dl::DecodedInst* staticDecode(Sift::Instruction &inst);
 
@@ -68,74 +68,109 @@ void SmTransport::clearNodeForId(core_id_t core_id)
 
 SmTransport::SmNode::SmNode(core_id_t core_id, SmTransport *smt)
    : Node(core_id)
+   , m_incoming(NULL)
+   , m_pending(NULL)
+   , m_waiting(false)
    , m_smt(smt)
 {
 }
 
 SmTransport::SmNode::~SmNode()
 {
-   LOG_ASSERT_WARNING(m_queue.empty(), "Unread messages in queue for core: %d", getCoreId());
+   LOG_ASSERT_WARNING(!query(), "Unread messages in queue for core: %d", getCoreId());
+   while (fetch())
+   {
+      BufferHeader *header = m_pending;
+      m_pending = header->next;
+      freeBuffer(getBuffer(header));
+   }
    m_smt->clearNodeForId(getCoreId());
 }
 
 void SmTransport::SmNode::globalSend(SInt32 dest_proc, const void *buffer, UInt32 length)
 {
    LOG_ASSERT_ERROR(dest_proc == 0, "Destination other than zero: %d", dest_proc);
-   send((SmNode*)m_smt->getGlobalNode(), buffer, length);
+   Byte *data = allocBuffer(length);
+   memcpy(data, buffer, length);
+   sendBuffer((SmNode*)m_smt->getGlobalNode(), data);
 }
 
 void SmTransport::SmNode::send(SInt32 dest_id, const void* buffer, UInt32 length)
+{
+   Byte *data = allocBuffer(length);
+   memcpy(data, buffer, length);
+   sendBuffer(dest_id, data);
+}
+
+void SmTransport::SmNode::sendBuffer(SInt32 dest_id, Byte *buffer)
 {
    SmNode *dest_node = m_smt->getNodeFromId(dest_id);
    LOG_ASSERT_ERROR(dest_node != NULL, "Attempt to send to non-existent node: %d", dest_id);
-   send(dest_node, buffer, length);
+   sendBuffer(dest_node, buffer);
 }
 
-void SmTransport::SmNode::send(SmNode *dest_node, const void *buffer, UInt32 length)
+void SmTransport::SmNode::sendBuffer(SmNode *dest_node, Byte *buffer)
 {
-   Byte *data = new Byte[length];
-   memcpy(data, buffer, length);
+   LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", getHeader(buffer)->length, buffer, dest_node);
+
+   BufferHeader *header = getHeader(buffer);
+   BufferHeader *head = __atomic_load_n(&dest_node->m_incoming, __ATOMIC_RELAXED);
+   do
+   {
+      header->next = head;
+   }
+   while (!__atomic_compare_exchange_n(&dest_node->m_incoming, &head, header, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+   // Pairs with recv(): either the receiver sees our message before going to sleep, or we see it waiting
+   if (__atomic_load_n(&dest_node->m_waiting, __ATOMIC_SEQ_CST))
+   {
+      dest_node->m_lock.acquire();
+      dest_node->m_cond.signal();
+      dest_node->m_lock.release();
+   }
+}
 
-   LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, data, dest_node);
+bool SmTransport::SmNode::fetch()
+{
+   if (m_pending)
+      return true;
 
-   dest_node->m_lock.acquire();
-   dest_node->m_queue.push(data);
-   dest_node->m_lock.release();
-   dest_node->m_cond.broadcast();
+   BufferHeader *header = __atomic_exchange_n(&m_incoming, (BufferHeader*)NULL, __ATOMIC_ACQUIRE);
+   // The stack has the newest message on top, reverse it to get them in order
+   while (header)
+   {
+      BufferHeader *next = header->next;
+      header->next = m_pending;
+      m_pending = header;
+      header = next;
+   }
+   return m_pending != NULL;
 }
 
 Byte* SmTransport::SmNode::recv()
 {
    LOG_PRINT("attempting recv -- this: %p", this);
 
-   m_lock.acquire();
-
-   while (true)
+   while (!fetch())
    {
-      if (!m_queue.empty())
-      {
-         Byte *data = m_queue.front();
-         m_queue.pop();
-         m_lock.release();
-
-         LOG_PRINT("msg recv'd -- data: %p, this: %p", data, this);
-
-         return data;
-      }
-      else
-      {
+      m_lock.acquire();
+      __atomic_store_n(&m_waiting, true, __ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&m_incoming, __ATOMIC_SEQ_CST) == NULL)
          m_cond.wait(m_lock);
-      }
+      __atomic_store_n(&m_waiting, false, __ATOMIC_SEQ_CST);
+      m_lock.release();
    }
+
+   BufferHeader *header = m_pending;
+   m_pending = header->next;
+   Byte *data = getBuffer(header);
+
+   LOG_PRINT("msg recv'd -- data: %p, this: %p", data, this);
+
+   return data;
 }
 
 bool SmTransport::SmNode::query()
 {
-   bool result = false;
-
-   m_lock.acquire();
-   result = !m_queue.empty();
-   m_lock.release();
-
-   return result;
+   return m_pending != NULL || __atomic_load_n(&m_incoming, __ATOMIC_RELAXED) != NULL;
 }
@@ -1,8 +1,6 @@
 #ifndef SMTRANSPORT_H
 #define SMTRANSPORT_H
 
-#include <queue>
-
 #include "transport.h"
 #include "cond.h"
 
@@ -20,13 +18,21 @@ public:
 
       void globalSend(SInt32, const void*, UInt32);
       void send(core_id_t, const void*, UInt32);
+      void sendBuffer(core_id_t, Byte*);
       Byte* recv();
       bool query();
 
    private:
-      void send(SmNode *dest, const void *buffer, UInt32 length);
-
-      std::queue<Byte*> m_queue;
+      void sendBuffer(SmNode *dest, Byte *buffer);
+      bool fetch();
+
+      // Multiple-producer, single-consumer queue. Senders push onto a lock-free stack (m_incoming),
+      // the receiving thread takes the whole stack at once and reverses it into m_pending,
+      // which keeps messages from any one sender in order.
+      BufferHeader* volatile m_incoming;
+      BufferHeader *m_pending;
+      // Only used when the receiver has nothing to do and goes to sleep
+      volatile bool m_waiting;
       Lock m_lock;
       ConditionVariable m_cond;
       SmTransport *m_smt;
@@ -7,15 +7,50 @@
 
 #include "config.h"
 #include "log.h"
+#include "lock.h"
+#include "allocator.h"
 
 // -- Transport -- //
 
 Transport *Transport::m_singleton;
 
 Transport::Transport()
+   : m_buffer_allocator(new ThreadLocalAllocator<BufferSlot>())
 {
 }
 
+Transport::~Transport()
+{
+   delete m_buffer_allocator;
+}
+
+Byte* Transport::allocBuffer(UInt32 length)
+{
+   BufferHeader *header;
+   if (sizeof(BufferHeader) + length <= BUFFER_SLOT_SIZE)
+   {
+      header = (BufferHeader*)m_singleton->m_buffer_allocator->alloc(BUFFER_SLOT_SIZE);
+      header->pooled = true;
+   }
+   else
+   {
+      header = (BufferHeader*)new Byte[sizeof(BufferHeader) + length];
+      header->pooled = false;
+   }
+   header->next = NULL;
+   header->length = length;
+   return getBuffer(header);
+}
+
+void Transport::freeBuffer(Byte *buffer)
+{
+   BufferHeader *header = getHeader(buffer);
+   if (header->pooled)
+      Allocator::dealloc(header);
+   else
+      delete [] (Byte*)header;
+}
+
 Transport* Transport::create()
 {
    assert(m_singleton == NULL);
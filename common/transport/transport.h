@@ -5,10 +5,12 @@
 
 #include <map>
 
+class Allocator;
+
 class Transport
 {
 public:
-   virtual ~Transport() { };
+   virtual ~Transport();
 
    class Node
    {
@@ -16,7 +18,11 @@ public:
       virtual ~Node() { }
 
       virtual void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length) = 0;
+      // Copies buffer into a new packet buffer
       virtual void send(core_id_t dest, const void *buffer, UInt32 length) = 0;
+      // Hands over a buffer obtained from Transport::allocBuffer without copying it
+      virtual void sendBuffer(core_id_t dest, Byte *buffer) = 0;
+      // Returns a packet buffer, to be released with Transport::freeBuffer
       virtual Byte* recv() = 0;
       virtual bool query() = 0;
 
@@ -36,11 +42,32 @@ public:
    virtual void barrier() = 0;
    virtual Node* getGlobalNode() = 0; // for communication not linked to a core
 
+   // Packet buffers. Most packets fit in a fixed-size slot from a per-thread pool,
+   // larger ones fall back to the heap. Buffers may be freed by any thread.
+   static Byte* allocBuffer(UInt32 length);
+   static void freeBuffer(Byte *buffer);
+
 protected:
    Transport();
 
+   // Precedes every packet buffer, lets the transport queue buffers without allocating
+   struct BufferHeader
+   {
+      BufferHeader *next;
+      UInt32 length;
+      bool pooled;
+   };
+
+   static BufferHeader* getHeader(Byte *buffer) { return (BufferHeader*)(buffer - sizeof(BufferHeader)); }
+   static Byte* getBuffer(BufferHeader *header) { return (Byte*)header + sizeof(BufferHeader); }
+
 private:
    static Transport *m_singleton;
+
+   // A coherence message with a 64-byte cache line takes less than 200 bytes including the NetPacket header
+   static const UInt32 BUFFER_SLOT_SIZE = 256;
+   struct BufferSlot { Byte data[BUFFER_SLOT_SIZE]; };
+   Allocator *m_buffer_allocator;
 };
 
 #endif // TRANSPORT_H
@@ -48,7 +48,6 @@ void InstructionModeling::handleBasicBlock(THREADID thread_id)
       localStore[thread_id].dynins = NULL;
    }
 
-#ifndef ENABLE_PERF_MODEL_OWN_THREAD
    prfmdl->iterate();
    SubsecondTime time = prfmdl->getElapsedTime();
    if (thread->reschedule(time, core))
@@ -56,7 +55,6 @@ void InstructionModeling::handleBasicBlock(THREADID thread_id)
       core = thread->getCore();
       prfmdl = core->getPerformanceModel();
    }
-#endif
 }
 
 static void handleBranch(THREADID thread_id, ADDRINT eip, BOOL taken, ADDRINT target)
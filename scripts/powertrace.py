@@ -17,6 +17,7 @@ class PowerTrace:
       # ignore first callback which is at 100ns
       return
     sim.stats.write(str(time)) # write to sim.stats with prefix 'time'
+    sim.stats.flush() # make sure the snapshot is in the database before McPAT reads it
     self.do_power(self.t_last, time)
     self.t_last = time
 
@@ -24,6 +25,7 @@ class PowerTrace:
     self.t_roi_end = long(long(sim.stats.get('performance_model', 0, 'elapsed_time'))/1e6)
 
   def hook_sim_end(self):
+    sim.stats.flush()
     self.do_power(self.t_last, None)
 
   def do_power(self, t0, t1):
@@ -198,6 +198,7 @@ class EveryIns:
 have_deleted_stats = False
 def db_delete(prefix, in_sim_end = False):
   global have_deleted_stats
+  sim.stats.flush()
   cursor = sim.stats.db.cursor()
   prefixid = sim.stats.db.execute('SELECT prefixid FROM prefixes WHERE prefixname = ?', (prefix,)).fetchall()
   if prefixid:
@@ -9,6 +9,9 @@ KNOB<UINT64> KnobDetailedTarget(KNOB_MODE_WRITEONCE, "pintool", "d", "0", "instr
 KNOB<UINT64> KnobUseResponseFiles(KNOB_MODE_WRITEONCE, "pintool", "r", "0", "use response files (required for multithreaded applications or when emulating syscalls, default = 0)");
 KNOB<UINT64> KnobEmulateSyscalls(KNOB_MODE_WRITEONCE, "pintool", "e", "0", "emulate syscalls (required for multithreaded applications, default = 0)");
 KNOB<BOOL>   KnobSendPhysicalAddresses(KNOB_MODE_WRITEONCE, "pintool", "pa", "0", "send logical to physical address mapping");
+KNOB<std::string> KnobCompression(KNOB_MODE_WRITEONCE, "pintool", "compress", "zlib", "trace compression: none, zlib, zstd or lz4 (ignored when using response files)");
+KNOB<INT64> KnobCompressionLevel(KNOB_MODE_WRITEONCE, "pintool", "compress-level", "0", "trace compression level (0 = codec default)");
+KNOB<UINT64> KnobIndexChunk(KNOB_MODE_WRITEONCE, "pintool", "index", "0", "write a seekable trace with an index entry every N instructions (0 = disabled, ignored when using response files)");
 KNOB<UINT64> KnobFlowControl(KNOB_MODE_WRITEONCE, "pintool", "flow", "1000", "number of instructions to send before syncing up");
 KNOB<UINT64> KnobFlowControlFF(KNOB_MODE_WRITEONCE, "pintool", "flowff", "100000", "number of instructions to batch up before sending instruction counts in fast-forward mode");
 KNOB<INT64> KnobSiftAppId(KNOB_MODE_WRITEONCE, "pintool", "s", "0", "sift app id (default = 0)");
@@ -33,6 +36,7 @@ INT32 app_id;
 INT32 num_threads = 0;
 UINT32 max_num_threads = MAX_NUM_THREADS_DEFAULT;
 UINT64 blocksize;
+UINT64 compression = Sift::CompressionZlib;
 UINT64 fast_forward_target = 0;
 UINT64 detailed_target = 0;
 PIN_LOCK access_memory_lock;
@@ -27,6 +27,9 @@ extern KNOB<UINT64> KnobDetailedTarget;
 extern KNOB<UINT64> KnobUseResponseFiles;
 extern KNOB<UINT64> KnobEmulateSyscalls;
 extern KNOB<BOOL>   KnobSendPhysicalAddresses;
+extern KNOB<std::string> KnobCompression;
+extern KNOB<INT64> KnobCompressionLevel;
+extern KNOB<UINT64> KnobIndexChunk;
 extern KNOB<UINT64> KnobFlowControl;
 extern KNOB<UINT64> KnobFlowControlFF;
 extern KNOB<INT64> KnobSiftAppId;
@@ -50,6 +53,7 @@ extern INT32 app_id;
 extern INT32 num_threads;
 extern UINT32 max_num_threads;
 extern UINT64 blocksize;
+extern UINT64 compression;
 extern UINT64 fast_forward_target;
 extern UINT64 detailed_target;
 extern PIN_LOCK access_memory_lock;
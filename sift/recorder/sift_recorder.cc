@@ -139,6 +139,25 @@ int main(int argc, char **argv)
    blocksize = KnobBlocksize.Value();
    fast_forward_target = KnobFastForwardTarget.Value();
    detailed_target = KnobDetailedTarget.Value();
+   if (KnobCompression.Value() == "none")
+      compression = 0;
+   else if (KnobCompression.Value() == "zlib")
+      compression = Sift::CompressionZlib;
+   else if (KnobCompression.Value() == "zstd" && SIFT_USE_ZSTD)
+      compression = Sift::CompressionZstd;
+   else if (KnobCompression.Value() == "lz4" && SIFT_USE_LZ4)
+      compression = Sift::CompressionLz4;
+   else if (KnobCompression.Value() == "zstd" || KnobCompression.Value() == "lz4")
+   {
+      std::cerr << "Error, " << KnobCompression.Value() << " compression is not available, rebuild the recorder with SIFT_USE_"
+                << (KnobCompression.Value() == "zstd" ? "ZSTD" : "LZ4") << "=1." << std::endl;
+      exit(1);
+   }
+   else
+   {
+      std::cerr << "Error, invalid compression type " << KnobCompression.Value() << ", expected none, zlib, zstd or lz4." << std::endl;
+      exit(1);
+   }
    if (KnobEmulateSyscalls.Value() || (!KnobUseROI.Value() && !KnobMPIImplicitROI.Value()))
    {
       if (app_id < 0)
@@ -18,6 +18,21 @@
 # define SIFT_USE_ZLIB 1
 #endif
 
+// zstd and lz4 compression are optional, enable by building with SIFT_USE_ZSTD=1 and/or SIFT_USE_LZ4=1
+#ifndef SIFT_USE_ZSTD
+# define SIFT_USE_ZSTD 0
+#endif
+#ifndef SIFT_USE_LZ4
+# define SIFT_USE_LZ4 0
+#endif
+
+// The asynchronous reader (Reader::setAsync) uses std::thread, which is not available under PinCRT
+#if defined(PIN_CRT)
+# define SIFT_USE_ASYNC_READER 0
+#else
+# define SIFT_USE_ASYNC_READER 1
+#endif
+
 namespace Sift
 {
 
@@ -42,8 +57,34 @@ namespace Sift
       ArchIA32 = 2,
       IcacheVariable = 4,
       PhysicalAddress = 8,
+      CompressionZstd = 16,
+      CompressionLz4 = 32,
+      Indexed = 64,
    } Option;
 
+   // Indexed traces consist of chunks that are compressed independently, each starting with the state
+   // needed to decode it: icache pages and virtual-to-physical mappings are sent again in every chunk,
+   // the remaining address and ISA state is stored in the chunk's index entry.
+   // Every chunk but the last ends with a RecOtherChunkEnd record, the last one with RecOtherEnd.
+   // The (uncompressed) index follows the last chunk, the file ends with an IndexTrailer.
+   const uint32_t IndexMagicNumber = 0x58444953; // "SIDX"
+
+   typedef struct
+   {
+      uint64_t icount;           //< Number of instructions before the start of this chunk
+      uint64_t offset;           //< File offset of the chunk
+      uint64_t last_address;     //< Address state at the start of the chunk
+      uint32_t isa;              //< ISA mode at the start of the chunk
+      uint32_t reserved;
+   } __attribute__ ((__packed__)) IndexEntry;
+
+   typedef struct
+   {
+      uint64_t offset;           //< File offset of the first IndexEntry
+      uint64_t num_entries;
+      uint32_t magic;
+   } __attribute__ ((__packed__)) IndexTrailer;
+
    typedef union
    {
       // Simple format for common instructions
@@ -115,6 +156,7 @@ namespace Sift
       RecOtherInstructionCount,
       RecOtherCacheOnly,
       RecOtherISAChange,
+      RecOtherChunkEnd,
       RecOtherEnd = 0xff,
    } RecOtherType;
 
@@ -10,6 +10,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <sched.h>
 
 // Enable (>0) to print out everything we read
 #define VERBOSE 0
@@ -50,6 +51,22 @@ Sift::Reader::Reader(const char *filename, const char *response_filename, uint32
    , m_seen_end(false)
    , m_last_sinst(NULL)
    , m_isa(0)
+   , m_file(NULL)
+   , m_index()
+   , m_chunk(0)
+   , m_compression(0)
+   , m_icount(0)
+   , m_async(false)
+#if SIFT_USE_ASYNC_READER
+   , m_async_thread(NULL)
+   , m_async_batches(NULL)
+   , m_async_head(0)
+   , m_async_tail(0)
+   , m_async_stop(false)
+   , m_async_position(0)
+   , m_async_index(0)
+   , m_async_failed(false)
+#endif
 {
 //   if (!xed_initialized)
 //   {
@@ -69,10 +86,15 @@ Sift::Reader::Reader(const char *filename, const char *response_filename, uint32
 
 Sift::Reader::~Reader()
 {
+#if SIFT_USE_ASYNC_READER
+   stopAsync();
+#endif
    free(m_filename);
    free(m_response_filename);
    if (input)
       delete input;
+   if (m_file)
+      delete m_file;
    if (response)
       delete response;
    for(std::unordered_map<uint64_t, const uint8_t*>::iterator i = icache.begin() ; i != icache.end() ; ++i)
@@ -120,7 +142,7 @@ bool Sift::Reader::initStream()
 #if SIFT_USE_ZLIB
    if (hdr.options & CompressionZlib)
    {
-      input = new izstream(input);
+      m_compression = CompressionZlib;
       hdr.options &= ~CompressionZlib;
    }
 #else
@@ -130,6 +152,32 @@ bool Sift::Reader::initStream()
    }
 #endif
 
+#if SIFT_USE_ZSTD
+   if (hdr.options & CompressionZstd)
+   {
+      m_compression = CompressionZstd;
+      hdr.options &= ~CompressionZstd;
+   }
+#else
+   if (hdr.options & CompressionZstd)
+   {
+      std::cerr << "[SIFT:" << m_id << "] Error: zstd compression requested, but disabled at compile time.\n";
+   }
+#endif
+
+#if SIFT_USE_LZ4
+   if (hdr.options & CompressionLz4)
+   {
+      m_compression = CompressionLz4;
+      hdr.options &= ~CompressionLz4;
+   }
+#else
+   if (hdr.options & CompressionLz4)
+   {
+      std::cerr << "[SIFT:" << m_id << "] Error: lz4 compression requested, but disabled at compile time.\n";
+   }
+#endif
+
    if (hdr.options & ArchIA32)
    {
       //xed_state_t init = { XED_MACHINE_MODE_LONG_COMPAT_32, XED_ADDRESS_WIDTH_32b };
@@ -150,6 +198,15 @@ bool Sift::Reader::initStream()
 
    hdr.options &= ~IcacheVariable;
 
+   if (hdr.options & Indexed)
+   {
+      if (!readIndex())
+         return false;
+      hdr.options &= ~Indexed;
+   }
+   else
+      input = openCompression(input);
+
    // Make sure there are no unrecognized options
    if (hdr.options != 0)
    {
@@ -160,6 +217,148 @@ bool Sift::Reader::initStream()
    std::cerr << "[DEBUG:" << m_id << "] InitStream Connection Open" << std::endl;
    #endif
 
+#if SIFT_USE_ASYNC_READER
+   if (m_async && strcmp(m_response_filename, "") == 0)
+      startAsync();
+#endif
+
+   return true;
+}
+
+vistream *Sift::Reader::openCompression(vistream *stream)
+{
+#if SIFT_USE_ZLIB
+   if (m_compression == CompressionZlib)
+      return new izstream(stream);
+#endif
+#if SIFT_USE_ZSTD
+   if (m_compression == CompressionZstd)
+      return new izstdstream(stream);
+#endif
+#if SIFT_USE_LZ4
+   if (m_compression == CompressionLz4)
+      return new ilz4stream(stream);
+#endif
+   return stream;
+}
+
+bool Sift::Reader::readIndex()
+{
+   IndexTrailer trailer;
+   if (filesize < sizeof(Header) + sizeof(trailer))
+   {
+      std::cerr << "[SIFT:" << m_id << "] Error: Indexed trace is too short, an index can only be read from a complete trace file\n";
+      return false;
+   }
+   inputstream->seekg(filesize - sizeof(trailer));
+   inputstream->read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+   if (inputstream->fail() || trailer.magic != IndexMagicNumber || trailer.num_entries == 0)
+   {
+      std::cerr << "[SIFT:" << m_id << "] Error: Invalid trace index\n";
+      return false;
+   }
+
+   m_index.resize(trailer.num_entries);
+   inputstream->seekg(trailer.offset);
+   inputstream->read(reinterpret_cast<char*>(&m_index[0]), trailer.num_entries * sizeof(IndexEntry));
+   if (inputstream->fail())
+   {
+      std::cerr << "[SIFT:" << m_id << "] Error: Invalid trace index\n";
+      m_index.clear();
+      return false;
+   }
+
+   #if VERBOSE > 0
+   std::cerr << "[DEBUG:" << m_id << "] Read index with " << m_index.size() << " chunks" << std::endl;
+   #endif
+
+   // The raw file stays open underneath the (de)compression stream of the current chunk
+   m_file = input;
+   input = NULL;
+   openChunk(0);
+
+   return true;
+}
+
+void Sift::Reader::openChunk(size_t chunk)
+{
+   #if VERBOSE > 0
+   std::cerr << "[DEBUG:" << m_id << "] Open Chunk " << chunk << std::endl;
+   #endif
+
+   if (input)
+      delete input;
+
+   // Decompressors read ahead, so always position the file at the start of the chunk
+   inputstream->clear();
+   inputstream->seekg(m_index[chunk].offset);
+   input = openCompression(new virefstream(m_file));
+
+   m_chunk = chunk;
+   m_icount = m_index[chunk].icount;
+   last_address = m_index[chunk].last_address;
+   m_isa = m_index[chunk].isa;
+}
+
+bool Sift::Reader::Seek(uint64_t icount)
+{
+   if (input == NULL)
+   {
+      if (!initStream())
+      {
+         std::cerr << "[SIFT:" << m_id << "] Error: initStream failed\n";
+         return false;
+      }
+   }
+
+   if (m_index.empty())
+   {
+      std::cerr << "[SIFT:" << m_id << "] Error: Seeking requires an indexed trace\n";
+      return false;
+   }
+
+#if SIFT_USE_ASYNC_READER
+   bool async = (m_async_thread != NULL);
+   stopAsync();
+#endif
+
+   // Last chunk that starts at or before the requested instruction
+   size_t chunk = 0;
+   while (chunk + 1 < m_index.size() && m_index[chunk + 1].icount <= icount)
+      ++chunk;
+
+   openChunk(chunk);
+   m_seen_end = false;
+   m_last_sinst = NULL;
+
+   // Skip instructions without going through Read(), which would run the callbacks of all records on the way
+   Instruction inst;
+   while (m_icount < icount)
+   {
+      uint8_t byte = input->peek();
+      if (input->fail())
+      {
+         std::cerr << "[SIFT:" << m_id << "] Error: " << strerror(errno) << "\n";
+         return false;
+      }
+
+      if (byte == 0)
+      {
+         Record rec;
+         input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+         if (!skipOtherRecord(rec, input))
+            return false;
+         continue;
+      }
+
+      readInstruction(inst);
+   }
+
+#if SIFT_USE_ASYNC_READER
+   if (async)
+      startAsync();
+#endif
+
    return true;
 }
 
@@ -195,6 +394,11 @@ bool Sift::Reader::Read(Instruction &inst)
       }
    }
 
+#if SIFT_USE_ASYNC_READER
+   if (m_async_thread)
+      return readAsync(inst);
+#endif
+
    while(!m_seen_end)
    {
       Record rec;
@@ -209,359 +413,550 @@ bool Sift::Reader::Read(Instruction &inst)
       {
          // Other
          input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
-         switch(rec.Other.type)
-         {
-            case RecOtherEnd:
-               assert(rec.Other.size == 0);
-               m_seen_end = true;
-               // disable EndResponse as it causes lockups with sift_recorder
-               //sendSimpleResponse(RecOtherEndResponse);
-               return false;
-            case RecOtherIcache:
-            {
-               assert(rec.Other.size == sizeof(uint64_t) + ICACHE_SIZE);
-               uint64_t address;
-               uint8_t *bytes = new uint8_t[ICACHE_SIZE];
-               input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(bytes), ICACHE_SIZE);
-               icache[address] = bytes;
-               break;
-            }
-            case RecOtherIcacheVariable:
-            {
-               #if VERBOSE_ICACHE
-               std::cerr << __FUNCTION__ << ": rec=" << std::endl;
-               hexdump(&rec, sizeof(rec.Other));
-               #endif
-               uint64_t address;
-               size_t size = rec.Other.size - sizeof(uint64_t);
-               input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
-               size_t size_left = size;
-               while (size_left > 0)
-               {
-                  uint64_t base_addr = address & ICACHE_PAGE_MASK;
-                  if (icache.count(base_addr) == 0)
-                     icache[base_addr] = new uint8_t[ICACHE_SIZE];
-                  uint64_t offset = address & ICACHE_OFFSET_MASK;
-                  size_t read_amount = std::min(size_left, size_t(ICACHE_SIZE - offset));
-                  input->read(const_cast<char*>(reinterpret_cast<const char*>(&(icache[base_addr][offset]))), read_amount);
-
-                  #if VERBOSE_ICACHE
-                  std::cerr << __FUNCTION__ << ": Wrote " << read_amount << " bytes to 0x" << std::hex << (void*)&(icache[base_addr][offset]) << std::dec << std::endl;
-                  hexdump(&(icache[base_addr][offset]), read_amount);
-                  #endif
-
-                  size_left -= read_amount;
-                  address = base_addr + ICACHE_SIZE;
-               }
-               break;
-            }
-            case RecOtherLogical2Physical:
-            {
-               assert(rec.Other.size == 2 * sizeof(uint64_t));
-               uint64_t vp, pp;
-               input->read(reinterpret_cast<char*>(&vp), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&pp), sizeof(uint64_t));
-               vcache[vp] = pp;
-               break;
-            }
-            case RecOtherInstructionCount:
-            {
-               #if VERBOSE > 0
-               std::cerr << "[DEBUG:" << m_id << "] Read InstructionCount" << std::endl;
-               #endif
-               assert(rec.Other.size == sizeof(uint32_t));
-               uint32_t icount;
-               input->read(reinterpret_cast<char*>(&icount), sizeof(icount));
-               Mode mode = ModeUnknown;
-               if (handleInstructionCountFunc)
-                  mode = handleInstructionCountFunc(handleInstructionCountArg, icount);
-               sendSimpleResponse(RecOtherSyncResponse, &mode, sizeof(Mode));
-               break;
-            }
-            case RecOtherCacheOnly:
-            {
-               #if VERBOSE > 0
-               std::cerr << "[DEBUG:" << m_id << "] Read CacheOnly" << std::endl;
-               #endif
-               assert(rec.Other.size == sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint64_t));
-               uint8_t icount, type;
-               uint64_t eip, address;
-               input->read(reinterpret_cast<char*>(&icount), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(&type), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
-               if (handleCacheOnlyFunc)
-                  handleCacheOnlyFunc(handleCacheOnlyArg, icount, (Sift::CacheOnlyType)type, eip, address);
-               break;
-            }
-            case RecOtherOutput:
-            {
-               #if VERBOSE > 0
-               std::cerr << "[DEBUG:" << m_id << "] Read Output" << std::endl;
-               #endif
-               assert(rec.Other.size > sizeof(uint8_t));
-               uint8_t fd;
-               uint32_t size = rec.Other.size - sizeof(uint8_t);
-               uint8_t *bytes = new uint8_t[size];
-               input->read(reinterpret_cast<char*>(&fd), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(bytes), size);
-               if (handleOutputFunc)
-                  handleOutputFunc(handleOutputArg, fd, bytes, size);
-               delete [] bytes;
-               break;
-            }
-            case RecOtherSyscallRequest:
-            {
-               #if VERBOSE > 0
-               std::cerr << "[DEBUG:" << m_id << "] Read SyscallRequest" << std::endl;
-               #endif
-               assert(rec.Other.size > sizeof(uint16_t));
-               uint16_t syscall_number;
-               uint32_t size = rec.Other.size - sizeof(uint16_t);
-               uint8_t *bytes = new uint8_t[size];
-               input->read(reinterpret_cast<char*>(&syscall_number), sizeof(uint16_t));
-               input->read(reinterpret_cast<char*>(bytes), size);
-               #if VERBOSE_HEX > 0
-               hexdump((char*)&rec, sizeof(rec.Other));
-               hexdump((char*)&syscall_number, sizeof(syscall_number));
-               hexdump((char*)bytes, size);
-               #endif
-               #if VERBOSE > 1
-               for (int i = 0 ; i < (size/8) ; i++)
-               {
-                  std::cerr << __FUNCTION__ << ": syscall args[" << i << "] = " << ((uint64_t*)bytes)[i] << std::endl;
-               }
-               #endif
-
-               assert(handleSyscallFunc);
-               if (handleSyscallFunc)
-               {
-                  #if VERBOSE > 0
-                  std::cerr << "[DEBUG:" << m_id << "] HandleSyscall" << std::endl;
-                  #endif
-                  uint64_t ret = handleSyscallFunc(handleSyscallArg, syscall_number, bytes, size);
-                  sendSyscallResponse(ret);
-               }
-               delete [] bytes;
-               break;
-            }
-            case RecOtherNewThread:
-            {
-               assert(rec.Other.size == 0);
-               assert(handleNewThreadFunc);
-               if (handleNewThreadFunc)
-               {
-                  #if VERBOSE > 0
-                  std::cerr << "[DEBUG:" << m_id << "] HandleNewThread" << std::endl;
-                  #endif
-                  int32_t ret = handleNewThreadFunc(handleNewThreadArg);
-                  sendSimpleResponse(RecOtherNewThreadResponse, &ret, sizeof(ret));
-                  #if VERBOSE > 0
-                  std::cerr << "[DEBUG:" << m_id << "] HandleNewThread Done" << std::endl;
-                  #endif
-               }
-               break;
-            }
-            case RecOtherJoin:
-            {
-               int32_t thread;
-               assert(rec.Other.size == sizeof(thread));
-               input->read(reinterpret_cast<char*>(&thread), sizeof(thread));
-               assert(handleJoinFunc);
-               if (handleJoinFunc)
-               {
-                  #if VERBOSE > 0
-                  std::cerr << "[DEBUG:" << m_id << "] HandleJoin" << std::endl;
-                  #endif
-                  int32_t ret = handleJoinFunc(handleJoinArg, thread);
-                  sendSimpleResponse(RecOtherJoinResponse, &ret, sizeof(ret));
-                  #if VERBOSE > 0
-                  std::cerr << "[DEBUG:" << m_id << "] HandleJoin Done" << std::endl;
-                  #endif
-               }
-               break;
-            }
-            case RecOtherSync:
-            {
-               assert(rec.Other.size == 0);
-               Mode mode = ModeUnknown;
-               if (handleInstructionCountFunc)
-                  mode = handleInstructionCountFunc(handleInstructionCountArg, 0);
-               sendSimpleResponse(RecOtherSyncResponse, &mode, sizeof(Mode));
-               break;
-            }
-            case RecOtherFork:
-            {
-               assert(rec.Other.size == 0);
-               assert(handleForkFunc);
-               if(handleForkFunc)
-               {
-                  #if VERBOSE > 0
-                  std::cerr << "[DEBUG:" << m_id << "] HandleFork" << std::endl;
-                  #endif
-                  int32_t ret = handleForkFunc(handleForkArg);
-                  sendSimpleResponse(RecOtherForkResponse, &ret, sizeof(ret));
-                  #if VERBOSE > 0
-                  std::cerr << "[DEBUG:" << m_id << "] HandleFork Done" << std::endl;
-                  #endif
-               }
-               break;
-            }
-            case RecOtherMagicInstruction:
-            {
-               assert(rec.Other.size == 3 * sizeof(uint64_t));
-               uint64_t a, b, c;
-               input->read(reinterpret_cast<char*>(&a), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&b), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&c), sizeof(uint64_t));
-               uint64_t result;
-               if (handleMagicFunc)
-               {
-                  result = handleMagicFunc(handleMagicArg, a, b, c);
-               }
-               else
-               {
-                  result = a; // Do not modify GAX register
-               }
-               sendSimpleResponse(RecOtherMagicInstructionResponse, &result, sizeof(result));
-               break;
-            }
-            case RecOtherEmu:
-            {
-               assert(rec.Other.size <= sizeof(uint16_t) + sizeof(EmuRequest));
-               uint16_t type; EmuRequest req;
-               input->read(reinterpret_cast<char*>(&type), sizeof(uint16_t));
-               input->read(reinterpret_cast<char*>(&req), rec.Other.size - sizeof(uint16_t));
-               bool result = false; EmuReply res = {};
-               if (handleEmuFunc)
-               {
-                  result = handleEmuFunc(handleEmuArg, EmuType(type), req, res);
-               }
-               sendEmuResponse(result, res);
-               break;
-            }
-            case RecOtherRoutineChange:
-            {
-               assert(rec.Other.size == sizeof(uint8_t) + 3 * sizeof(uint64_t));
-               uint8_t event;
-               uint64_t eip, esp, callEip;
-               input->read(reinterpret_cast<char*>(&event), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&esp), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&callEip), sizeof(uint64_t));
-               if (handleRoutineChangeFunc)
-                  handleRoutineChangeFunc(handleRoutineArg, Sift::RoutineOpType(event), eip, esp, callEip);
-               break;
-            }
-            case RecOtherRoutineAnnounce:
-            {
-               uint64_t eip, offset;
-               uint16_t len_name, len_imgname, len_filename;
-               char *name, *imgname, *filename;
-               uint32_t line, column;
-               input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&len_name), sizeof(uint16_t));
-               name = (char*)malloc(len_name);
-               input->read(name, len_name);
-               input->read(reinterpret_cast<char*>(&len_imgname), sizeof(uint16_t));
-               imgname = (char*)malloc(len_imgname);
-               input->read(imgname, len_imgname);
-               input->read(reinterpret_cast<char*>(&offset), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&line), sizeof(uint32_t));
-               input->read(reinterpret_cast<char*>(&column), sizeof(uint32_t));
-               input->read(reinterpret_cast<char*>(&len_filename), sizeof(uint16_t));
-               filename = (char*)malloc(len_filename);
-               input->read(filename, len_filename);
-               if (handleRoutineAnnounceFunc)
-                  handleRoutineAnnounceFunc(handleRoutineArg, eip, name, imgname, offset, line, column, filename);
-               free(name);
-               free(filename);
-               break;
-            }            
-            case RecOtherISAChange:
-            { 
-               assert(rec.Other.size == sizeof(uint32_t));
-               uint32_t new_isa;
-               input->read(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
-               m_isa = new_isa; // save here new ISA mode value
-
-               break;
-            }
-            default:
-            {
-               uint8_t *bytes = new uint8_t[rec.Other.size];
-               input->read(reinterpret_cast<char*>(bytes), rec.Other.size);
-               delete [] bytes;
-               break;
-            }
-         }
+         if (!handleOtherRecord(rec, input))
+            return false;
          continue;
       }
 
-      uint8_t size;
-      uint64_t addr;
+      readInstruction(inst);
+      return true;
+   }
 
-      if ((byte & 0xf) != 0)
-      {
-         // Instruction
-         input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Instruction));
+   // We should not return false (no more instructions) unless we get the End packet.
+   // Return true in case we get to this point (which we shouldn't).
+   return true;
+}
 
-         #if VERBOSE_HEX > 2
-         hexdump(&rec, sizeof(rec.Instruction));
+// Handle a non-instruction record whose header has already been read, reading its payload from in.
+// Returns false when this is the End record.
+bool Sift::Reader::handleOtherRecord(Record &rec, vistream *in)
+{
+   switch(rec.Other.type)
+   {
+      case RecOtherEnd:
+         assert(rec.Other.size == 0);
+         m_seen_end = true;
+         // disable EndResponse as it causes lockups with sift_recorder
+         //sendSimpleResponse(RecOtherEndResponse);
+         return false;
+      case RecOtherIcache:
+      {
+         assert(rec.Other.size == sizeof(uint64_t) + ICACHE_SIZE);
+         uint64_t address;
+         uint8_t *bytes = new uint8_t[ICACHE_SIZE];
+         in->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(bytes), ICACHE_SIZE);
+         // Indexed traces send pages again in every chunk. Decoded instructions hold a copy of their bytes, so the old page can go.
+         if (icache.count(address))
+            delete [] icache[address];
+         icache[address] = bytes;
+         break;
+      }
+      case RecOtherIcacheVariable:
+      {
+         #if VERBOSE_ICACHE
+         std::cerr << __FUNCTION__ << ": rec=" << std::endl;
+         hexdump(&rec, sizeof(rec.Other));
          #endif
-
-         size = rec.Instruction.size;
-         addr = last_address;
-         inst.num_addresses = rec.Instruction.num_addresses;
-         inst.is_branch = rec.Instruction.is_branch;
-         inst.taken = rec.Instruction.taken;
-         inst.is_predicate = false;
-         inst.executed = true;
-         inst.isa = m_isa;
+         uint64_t address;
+         size_t size = rec.Other.size - sizeof(uint64_t);
+         in->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
+         size_t size_left = size;
+         while (size_left > 0)
+         {
+            uint64_t base_addr = address & ICACHE_PAGE_MASK;
+            if (icache.count(base_addr) == 0)
+               icache[base_addr] = new uint8_t[ICACHE_SIZE];
+            uint64_t offset = address & ICACHE_OFFSET_MASK;
+            size_t read_amount = std::min(size_left, size_t(ICACHE_SIZE - offset));
+            in->read(const_cast<char*>(reinterpret_cast<const char*>(&(icache[base_addr][offset]))), read_amount);
+
+            #if VERBOSE_ICACHE
+            std::cerr << __FUNCTION__ << ": Wrote " << read_amount << " bytes to 0x" << std::hex << (void*)&(icache[base_addr][offset]) << std::dec << std::endl;
+            hexdump(&(icache[base_addr][offset]), read_amount);
+            #endif
+
+            size_left -= read_amount;
+            address = base_addr + ICACHE_SIZE;
+         }
+         break;
       }
-      else
+      case RecOtherLogical2Physical:
       {
-         // InstructionExt
-         input->read(reinterpret_cast<char*>(&rec), sizeof(rec.InstructionExt));
-
-         #if VERBOSE_HEX > 2
-         hexdump(&rec, sizeof(rec.InstructionExt));
+         assert(rec.Other.size == 2 * sizeof(uint64_t));
+         uint64_t vp, pp;
+         in->read(reinterpret_cast<char*>(&vp), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(&pp), sizeof(uint64_t));
+         vcache[vp] = pp;
+         break;
+      }
+      case RecOtherInstructionCount:
+      {
+         #if VERBOSE > 0
+         std::cerr << "[DEBUG:" << m_id << "] Read InstructionCount" << std::endl;
+         #endif
+         assert(rec.Other.size == sizeof(uint32_t));
+         uint32_t icount;
+         in->read(reinterpret_cast<char*>(&icount), sizeof(icount));
+         Mode mode = ModeUnknown;
+         if (handleInstructionCountFunc)
+            mode = handleInstructionCountFunc(handleInstructionCountArg, icount);
+         sendSimpleResponse(RecOtherSyncResponse, &mode, sizeof(Mode));
+         break;
+      }
+      case RecOtherCacheOnly:
+      {
+         #if VERBOSE > 0
+         std::cerr << "[DEBUG:" << m_id << "] Read CacheOnly" << std::endl;
+         #endif
+         assert(rec.Other.size == sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint64_t));
+         uint8_t icount, type;
+         uint64_t eip, address;
+         in->read(reinterpret_cast<char*>(&icount), sizeof(uint8_t));
+         in->read(reinterpret_cast<char*>(&type), sizeof(uint8_t));
+         in->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
+         if (handleCacheOnlyFunc)
+            handleCacheOnlyFunc(handleCacheOnlyArg, icount, (Sift::CacheOnlyType)type, eip, address);
+         break;
+      }
+      case RecOtherOutput:
+      {
+         #if VERBOSE > 0
+         std::cerr << "[DEBUG:" << m_id << "] Read Output" << std::endl;
+         #endif
+         assert(rec.Other.size > sizeof(uint8_t));
+         uint8_t fd;
+         uint32_t size = rec.Other.size - sizeof(uint8_t);
+         uint8_t *bytes = new uint8_t[size];
+         in->read(reinterpret_cast<char*>(&fd), sizeof(uint8_t));
+         in->read(reinterpret_cast<char*>(bytes), size);
+         if (handleOutputFunc)
+            handleOutputFunc(handleOutputArg, fd, bytes, size);
+         delete [] bytes;
+         break;
+      }
+      case RecOtherSyscallRequest:
+      {
+         #if VERBOSE > 0
+         std::cerr << "[DEBUG:" << m_id << "] Read SyscallRequest" << std::endl;
+         #endif
+         assert(rec.Other.size > sizeof(uint16_t));
+         uint16_t syscall_number;
+         uint32_t size = rec.Other.size - sizeof(uint16_t);
+         uint8_t *bytes = new uint8_t[size];
+         in->read(reinterpret_cast<char*>(&syscall_number), sizeof(uint16_t));
+         in->read(reinterpret_cast<char*>(bytes), size);
+         #if VERBOSE_HEX > 0
+         hexdump((char*)&rec, sizeof(rec.Other));
+         hexdump((char*)&syscall_number, sizeof(syscall_number));
+         hexdump((char*)bytes, size);
+         #endif
+         #if VERBOSE > 1
+         for (int i = 0 ; i < (size/8) ; i++)
+         {
+            std::cerr << __FUNCTION__ << ": syscall args[" << i << "] = " << ((uint64_t*)bytes)[i] << std::endl;
+         }
          #endif
 
-         size = rec.InstructionExt.size;
-         addr = rec.InstructionExt.addr;
-         inst.num_addresses = rec.InstructionExt.num_addresses;
-         inst.is_branch = rec.InstructionExt.is_branch;
-         inst.taken = rec.InstructionExt.taken;
-         inst.is_predicate = rec.InstructionExt.is_predicate;
-         inst.executed = rec.InstructionExt.executed;
-         inst.isa = m_isa;
-
-         last_address = addr;
+         assert(handleSyscallFunc);
+         if (handleSyscallFunc)
+         {
+            #if VERBOSE > 0
+            std::cerr << "[DEBUG:" << m_id << "] HandleSyscall" << std::endl;
+            #endif
+            uint64_t ret = handleSyscallFunc(handleSyscallArg, syscall_number, bytes, size);
+            sendSyscallResponse(ret);
+         }
+         delete [] bytes;
+         break;
+      }
+      case RecOtherNewThread:
+      {
+         assert(rec.Other.size == 0);
+         assert(handleNewThreadFunc);
+         if (handleNewThreadFunc)
+         {
+            #if VERBOSE > 0
+            std::cerr << "[DEBUG:" << m_id << "] HandleNewThread" << std::endl;
+            #endif
+            int32_t ret = handleNewThreadFunc(handleNewThreadArg);
+            sendSimpleResponse(RecOtherNewThreadResponse, &ret, sizeof(ret));
+            #if VERBOSE > 0
+            std::cerr << "[DEBUG:" << m_id << "] HandleNewThread Done" << std::endl;
+            #endif
+         }
+         break;
+      }
+      case RecOtherJoin:
+      {
+         int32_t thread;
+         assert(rec.Other.size == sizeof(thread));
+         in->read(reinterpret_cast<char*>(&thread), sizeof(thread));
+         assert(handleJoinFunc);
+         if (handleJoinFunc)
+         {
+            #if VERBOSE > 0
+            std::cerr << "[DEBUG:" << m_id << "] HandleJoin" << std::endl;
+            #endif
+            int32_t ret = handleJoinFunc(handleJoinArg, thread);
+            sendSimpleResponse(RecOtherJoinResponse, &ret, sizeof(ret));
+            #if VERBOSE > 0
+            std::cerr << "[DEBUG:" << m_id << "] HandleJoin Done" << std::endl;
+            #endif
+         }
+         break;
       }
+      case RecOtherSync:
+      {
+         assert(rec.Other.size == 0);
+         Mode mode = ModeUnknown;
+         if (handleInstructionCountFunc)
+            mode = handleInstructionCountFunc(handleInstructionCountArg, 0);
+         sendSimpleResponse(RecOtherSyncResponse, &mode, sizeof(Mode));
+         break;
+      }
+      case RecOtherFork:
+      {
+         assert(rec.Other.size == 0);
+         assert(handleForkFunc);
+         if(handleForkFunc)
+         {
+            #if VERBOSE > 0
+            std::cerr << "[DEBUG:" << m_id << "] HandleFork" << std::endl;
+            #endif
+            int32_t ret = handleForkFunc(handleForkArg);
+            sendSimpleResponse(RecOtherForkResponse, &ret, sizeof(ret));
+            #if VERBOSE > 0
+            std::cerr << "[DEBUG:" << m_id << "] HandleFork Done" << std::endl;
+            #endif
+         }
+         break;
+      }
+      case RecOtherMagicInstruction:
+      {
+         assert(rec.Other.size == 3 * sizeof(uint64_t));
+         uint64_t a, b, c;
+         in->read(reinterpret_cast<char*>(&a), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(&b), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(&c), sizeof(uint64_t));
+         uint64_t result;
+         if (handleMagicFunc)
+         {
+            result = handleMagicFunc(handleMagicArg, a, b, c);
+         }
+         else
+         {
+            result = a; // Do not modify GAX register
+         }
+         sendSimpleResponse(RecOtherMagicInstructionResponse, &result, sizeof(result));
+         break;
+      }
+      case RecOtherEmu:
+      {
+         assert(rec.Other.size <= sizeof(uint16_t) + sizeof(EmuRequest));
+         uint16_t type; EmuRequest req;
+         in->read(reinterpret_cast<char*>(&type), sizeof(uint16_t));
+         in->read(reinterpret_cast<char*>(&req), rec.Other.size - sizeof(uint16_t));
+         bool result = false; EmuReply res = {};
+         if (handleEmuFunc)
+         {
+            result = handleEmuFunc(handleEmuArg, EmuType(type), req, res);
+         }
+         sendEmuResponse(result, res);
+         break;
+      }
+      case RecOtherRoutineChange:
+      {
+         assert(rec.Other.size == sizeof(uint8_t) + 3 * sizeof(uint64_t));
+         uint8_t event;
+         uint64_t eip, esp, callEip;
+         in->read(reinterpret_cast<char*>(&event), sizeof(uint8_t));
+         in->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(&esp), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(&callEip), sizeof(uint64_t));
+         if (handleRoutineChangeFunc)
+            handleRoutineChangeFunc(handleRoutineArg, Sift::RoutineOpType(event), eip, esp, callEip);
+         break;
+      }
+      case RecOtherRoutineAnnounce:
+      {
+         uint64_t eip, offset;
+         uint16_t len_name, len_imgname, len_filename;
+         char *name, *imgname, *filename;
+         uint32_t line, column;
+         in->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(&len_name), sizeof(uint16_t));
+         name = (char*)malloc(len_name);
+         in->read(name, len_name);
+         in->read(reinterpret_cast<char*>(&len_imgname), sizeof(uint16_t));
+         imgname = (char*)malloc(len_imgname);
+         in->read(imgname, len_imgname);
+         in->read(reinterpret_cast<char*>(&offset), sizeof(uint64_t));
+         in->read(reinterpret_cast<char*>(&line), sizeof(uint32_t));
+         in->read(reinterpret_cast<char*>(&column), sizeof(uint32_t));
+         in->read(reinterpret_cast<char*>(&len_filename), sizeof(uint16_t));
+         filename = (char*)malloc(len_filename);
+         in->read(filename, len_filename);
+         if (handleRoutineAnnounceFunc)
+            handleRoutineAnnounceFunc(handleRoutineArg, eip, name, imgname, offset, line, column, filename);
+         free(name);
+         free(filename);
+         break;
+      }            
+      case RecOtherChunkEnd:
+      {
+         assert(rec.Other.size == 0);
+         if (m_chunk + 1 >= m_index.size())
+         {
+            std::cerr << "[SIFT:" << m_id << "] Error: Unexpected end of chunk\n";
+            return false;
+         }
+         openChunk(m_chunk + 1);
+         break;
+      }
+      case RecOtherISAChange:
+      { 
+         assert(rec.Other.size == sizeof(uint32_t));
+         uint32_t new_isa;
+         in->read(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
+         m_isa = new_isa; // save here new ISA mode value
+
+         break;
+      }
+      default:
+      {
+         uint8_t *bytes = new uint8_t[rec.Other.size];
+         in->read(reinterpret_cast<char*>(bytes), rec.Other.size);
+         delete [] bytes;
+         break;
+      }
+   }
 
-      last_address += size;
+   return true;
+}
+
+// Handle a non-instruction record while seeking. Only records that carry reader state (instruction bytes,
+// address translations, ISA mode, chunk boundaries) are applied, all others are dropped without calling
+// their callbacks, as the seek happens before the thread runs on a core.
+// Returns false for records that cannot be skipped: the End record, and system calls and thread
+// creation or joins, whose effects the simulator must see.
+bool Sift::Reader::skipOtherRecord(Record &rec, vistream *in)
+{
+   switch(rec.Other.type)
+   {
+      case RecOtherIcache:
+      case RecOtherIcacheVariable:
+      case RecOtherLogical2Physical:
+      case RecOtherISAChange:
+      case RecOtherChunkEnd:
+         return handleOtherRecord(rec, in);
+      case RecOtherEnd:
+         std::cerr << "[SIFT:" << m_id << "] Error: Seek beyond the end of the trace\n";
+         return false;
+      case RecOtherSyscallRequest:
+      case RecOtherNewThread:
+      case RecOtherJoin:
+      case RecOtherFork:
+         std::cerr << "[SIFT:" << m_id << "] Error: Cannot seek past a system call, thread creation or join (at instruction " << m_icount << ")\n";
+         return false;
+      default:
+      {
+         uint8_t *bytes = new uint8_t[rec.Other.size];
+         in->read(reinterpret_cast<char*>(bytes), rec.Other.size);
+         delete [] bytes;
+         return true;
+      }
+   }
+}
 
-      for(int i = 0; i < inst.num_addresses; ++i)
-         input->read(reinterpret_cast<char*>(&inst.addresses[i]), sizeof(uint64_t));
+// Read the instruction record at the head of the input stream
+void Sift::Reader::readInstruction(Instruction &inst)
+{
+   Record rec;
+   uint8_t byte = input->peek();
+   uint8_t size;
+   uint64_t addr;
 
-      inst.sinst = getStaticInstruction(addr, size);
+   if ((byte & 0xf) != 0)
+   {
+      // Instruction
+      input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Instruction));
 
       #if VERBOSE_HEX > 2
-      hexdump(inst.sinst->data, inst.sinst->size);
+      hexdump(&rec, sizeof(rec.Instruction));
       #endif
-      #if VERBOSE > 2
-      printf("%016lx (%d) A%u %c%c %c%c\n", inst.sinst->addr, inst.sinst->size, inst.num_addresses, inst.is_branch?'B':'.', inst.is_branch?(inst.taken?'T':'.'):'.', inst.is_predicate?'C':'.', inst.is_predicate?(inst.executed?'E':'n'):'.');
+
+      size = rec.Instruction.size;
+      addr = last_address;
+      inst.num_addresses = rec.Instruction.num_addresses;
+      inst.is_branch = rec.Instruction.is_branch;
+      inst.taken = rec.Instruction.taken;
+      inst.is_predicate = false;
+      inst.executed = true;
+      inst.isa = m_isa;
+   }
+   else
+   {
+      // InstructionExt
+      input->read(reinterpret_cast<char*>(&rec), sizeof(rec.InstructionExt));
+
+      #if VERBOSE_HEX > 2
+      hexdump(&rec, sizeof(rec.InstructionExt));
       #endif
 
-      return true;
+      size = rec.InstructionExt.size;
+      addr = rec.InstructionExt.addr;
+      inst.num_addresses = rec.InstructionExt.num_addresses;
+      inst.is_branch = rec.InstructionExt.is_branch;
+      inst.taken = rec.InstructionExt.taken;
+      inst.is_predicate = rec.InstructionExt.is_predicate;
+      inst.executed = rec.InstructionExt.executed;
+      inst.isa = m_isa;
+
+      last_address = addr;
    }
 
-   // We should not return false (no more instructions) unless we get the End packet.
-   // Return true in case we get to this point (which we shouldn't).
+   last_address += size;
+   m_icount++;
+
+   for(int i = 0; i < inst.num_addresses; ++i)
+      input->read(reinterpret_cast<char*>(&inst.addresses[i]), sizeof(uint64_t));
+
+   inst.sinst = getStaticInstruction(addr, size);
+
+   #if VERBOSE_HEX > 2
+   hexdump(inst.sinst->data, inst.sinst->size);
+   #endif
+   #if VERBOSE > 2
+   printf("%016lx (%d) A%u %c%c %c%c\n", inst.sinst->addr, inst.sinst->size, inst.num_addresses, inst.is_branch?'B':'.', inst.is_branch?(inst.taken?'T':'.'):'.', inst.is_predicate?'C':'.', inst.is_predicate?(inst.executed?'E':'n'):'.');
+   #endif
+}
+
+#if SIFT_USE_ASYNC_READER
+void Sift::Reader::startAsync()
+{
+   m_async_head = 0;
+   m_async_tail = 0;
+   m_async_stop = false;
+   m_async_index = 0;
+   m_async_failed = false;
+   m_async_batches = new AsyncBatch[ASYNC_NUM_BATCHES];
+   m_async_thread = new std::thread(&Sift::Reader::asyncReadLoop, this);
+}
+
+void Sift::Reader::stopAsync()
+{
+   if (m_async_thread)
+   {
+      m_async_stop = true;
+      m_async_thread->join();
+      delete m_async_thread;
+      delete [] m_async_batches;
+      m_async_thread = NULL;
+      m_async_batches = NULL;
+   }
+}
+
+void Sift::Reader::asyncReadLoop()
+{
+   while(true)
+   {
+      // Wait for a free batch. We are usually ahead of the simulation, so sleep rather than spin.
+      uint64_t tail = m_async_tail.load(std::memory_order_relaxed);
+      while (tail - m_async_head.load(std::memory_order_acquire) == ASYNC_NUM_BATCHES)
+      {
+         if (m_async_stop)
+            return;
+         usleep(100);
+      }
+
+      AsyncBatch &batch = m_async_batches[tail % ASYNC_NUM_BATCHES];
+      batch.count = 0;
+      batch.other.clear();
+      batch.error = false;
+
+      bool done = false;
+      while (batch.count < ASYNC_BATCH_SIZE)
+      {
+         uint8_t byte = input->peek();
+         if (input->fail())
+         {
+            std::cerr << "[SIFT:" << m_id << "] Error: " << strerror(errno) << "\n";
+            batch.error = true;
+            done = true;
+            break;
+         }
+
+         if (byte == 0)
+         {
+            Record rec;
+            input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+            if (rec.Other.type == RecOtherIcache || rec.Other.type == RecOtherIcacheVariable || rec.Other.type == RecOtherISAChange || rec.Other.type == RecOtherChunkEnd)
+            {
+               handleOtherRecord(rec, input);
+               continue;
+            }
+            batch.other.resize(sizeof(rec.Other) + rec.Other.size);
+            memcpy(&batch.other[0], &rec, sizeof(rec.Other));
+            if (rec.Other.size > 0)
+               input->read(&batch.other[sizeof(rec.Other)], rec.Other.size);
+            done = (rec.Other.type == RecOtherEnd);
+            break;
+         }
+
+         readInstruction(batch.insts[batch.count++]);
+      }
+
+      m_async_position.store(inputstream->tellg(), std::memory_order_relaxed);
+      m_async_tail.store(tail + 1, std::memory_order_release);
+
+      if (done || m_async_stop)
+         return;
+   }
+}
+
+bool Sift::Reader::readAsync(Instruction &inst)
+{
+   while(!m_seen_end)
+   {
+      if (m_async_failed)
+         return false;
+
+      uint64_t head = m_async_head.load(std::memory_order_relaxed);
+      while (m_async_tail.load(std::memory_order_acquire) == head)
+         sched_yield();
+
+      AsyncBatch &batch = m_async_batches[head % ASYNC_NUM_BATCHES];
+      if (m_async_index < batch.count)
+      {
+         inst = batch.insts[m_async_index++];
+         return true;
+      }
+
+      // All instructions of this batch were returned, handle the record that ended it
+      bool more = !batch.error;
+      if (more && !batch.other.empty())
+      {
+         vimemstream in(&batch.other[0], batch.other.size());
+         Record rec;
+         in.read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+         more = handleOtherRecord(rec, &in);
+      }
+      if (batch.error)
+         m_async_failed = true;
+
+      m_async_index = 0;
+      m_async_head.store(head + 1, std::memory_order_release);
+
+      if (!more)
+         return false;
+   }
+
+   // See Read()
    return true;
 }
+#endif
 
 bool Sift::Reader::AccessMemory(MemoryLockType lock_signal, MemoryOpType mem_op, uint64_t d_addr, uint8_t *data_buffer, uint32_t data_size)
 {
@@ -791,6 +1186,10 @@ void Sift::Reader::sendSimpleResponse(RecOtherType type, void *data, uint32_t si
 
 uint64_t Sift::Reader::getPosition()
 {
+#if SIFT_USE_ASYNC_READER
+   if (m_async_thread)
+      return m_async_position.load(std::memory_order_relaxed);
+#endif
    if (inputstream)
       return inputstream->tellg();
    else
@@ -9,8 +9,13 @@
 //}
 
 #include <unordered_map>
+#include <vector>
 #include <fstream>
 #include <cassert>
+#if SIFT_USE_ASYNC_READER
+# include <atomic>
+# include <thread>
+#endif
 
 class vistream;
 class vostream;
@@ -103,7 +108,51 @@ namespace Sift
          
          int m_isa;
 
+         // Indexed traces: input decompresses the current chunk from m_file
+         vistream *m_file;
+         std::vector<IndexEntry> m_index;
+         size_t m_chunk;
+         uint64_t m_compression;
+         uint64_t m_icount;
+
+         bool m_async;
+#if SIFT_USE_ASYNC_READER
+         // Asynchronous mode: a background thread decompresses and parses the trace into batches of instructions,
+         // which are handed to the caller through a single-producer, single-consumer ring of batches.
+         // Records that only affect decoding (icache, ISA change) are handled by the background thread,
+         // all other records are passed along and handled in order when the caller reaches them.
+         static const uint32_t ASYNC_BATCH_SIZE = 1024;
+         static const uint32_t ASYNC_NUM_BATCHES = 16;
+         struct AsyncBatch
+         {
+            Instruction insts[ASYNC_BATCH_SIZE];
+            uint32_t count;
+            std::vector<char> other;   // Non-instruction record (header and payload) following the instructions
+            bool error;
+         };
+         std::thread *m_async_thread;
+         AsyncBatch *m_async_batches;
+         std::atomic<uint64_t> m_async_head;      // Next batch to consume, only written by the caller
+         std::atomic<uint64_t> m_async_tail;      // Next batch to produce, only written by the background thread
+         std::atomic<bool> m_async_stop;
+         std::atomic<uint64_t> m_async_position;
+         uint32_t m_async_index;                  // Next instruction to return from batch m_async_head
+         bool m_async_failed;
+#endif
+
          bool initResponse();
+         vistream *openCompression(vistream *stream);
+         bool readIndex();
+         void openChunk(size_t chunk);
+         bool handleOtherRecord(Record &rec, vistream *in);
+         bool skipOtherRecord(Record &rec, vistream *in);
+         void readInstruction(Instruction &inst);
+#if SIFT_USE_ASYNC_READER
+         void startAsync();
+         void stopAsync();
+         void asyncReadLoop();
+         bool readAsync(Instruction &inst);
+#endif
          const Sift::StaticInstruction* staticInfoInstruction(uint64_t addr, uint8_t size);
          const Sift::StaticInstruction* getStaticInstruction(uint64_t addr, uint8_t size);
          void sendSyscallResponse(uint64_t return_code);
@@ -115,6 +164,13 @@ namespace Sift
          ~Reader();
          bool initStream();
          bool Read(Instruction&);
+         // Continue reading at the icount'th instruction of the trace (counting from zero). Requires an indexed trace,
+         // starts decoding at the chunk that contains the instruction and skips the instructions before it.
+         bool Seek(uint64_t icount);
+         bool isIndexed() const { return !m_index.empty(); }
+         // Read ahead in a background thread. Must be set before the stream is opened.
+         // Only used for traces without a response channel, as responses are read from the same stream.
+         void setAsync(bool async) { m_async = async; }
          bool AccessMemory(MemoryLockType lock_signal, MemoryOpType mem_op, uint64_t d_addr, uint8_t *data_buffer, uint32_t data_size);
 
          void setHandleInstructionCountFunc(HandleInstructionCountFunc func, void* arg = NULL) { handleInstructionCountFunc = func; handleInstructionCountArg = arg; }
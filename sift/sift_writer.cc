@@ -35,7 +35,7 @@ __sift_assert_fail(__const char *__assertion, __const char *__file,
 }
 
 
-Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression, const char *response_filename, uint32_t id, bool arch32, bool requires_icache_per_insn, bool send_va2pa_mapping, GetCodeFunc2 getCodeFunc2, void* getCodeFunc2Data)
+Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, uint64_t compression, const char *response_filename, uint32_t id, bool arch32, bool requires_icache_per_insn, bool send_va2pa_mapping, GetCodeFunc2 getCodeFunc2, void* getCodeFunc2Data, int compression_level, uint64_t index_chunk_size)
    : response(NULL)
    , getCodeFunc(getCodeFunc)
    , getCodeFunc2(getCodeFunc2)
@@ -52,6 +52,13 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
    , m_id(id)
    , m_requires_icache_per_insn(requires_icache_per_insn)
    , m_send_va2pa_mapping(send_va2pa_mapping)
+   , m_options(0)
+   , m_compression_level(compression_level)
+   , m_isa(0)
+   , m_file(NULL)
+   , m_file_position(0)
+   , m_chunk_size(index_chunk_size)
+   , m_index()
 {
    memset(hsize, 0, sizeof(hsize));
    memset(haddr, 0, sizeof(haddr));
@@ -60,12 +67,28 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
 
    uint64_t options = 0;
 #if SIFT_USE_ZLIB
-   if (useCompression)
+   if (compression == CompressionZlib)
       options |= CompressionZlib;
 #else
-   if (useCompression) {
+   if (compression == CompressionZlib) {
       std::cerr << "[SIFT:" << m_id << "] Warning: Compression disabled, ignoring request.\n";
    }
+#endif
+#if SIFT_USE_ZSTD
+   if (compression == CompressionZstd)
+      options |= CompressionZstd;
+#else
+   if (compression == CompressionZstd) {
+      std::cerr << "[SIFT:" << m_id << "] Warning: zstd compression disabled, ignoring request.\n";
+   }
+#endif
+#if SIFT_USE_LZ4
+   if (compression == CompressionLz4)
+      options |= CompressionLz4;
+#else
+   if (compression == CompressionLz4) {
+      std::cerr << "[SIFT:" << m_id << "] Warning: lz4 compression disabled, ignoring request.\n";
+   }
 #endif
    if (arch32)
       options |= ArchIA32;
@@ -73,6 +96,9 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
       options |= IcacheVariable;
    if (m_send_va2pa_mapping)
       options |= PhysicalAddress;
+   if (m_chunk_size)
+      options |= Indexed;
+   m_options = options;
 
    output = new vofstream(filename, std::ios::out | std::ios::binary | std::ios::trunc);
 
@@ -91,8 +117,48 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
    output->write(reinterpret_cast<char*>(&hdr), sizeof(hdr));
    output->flush();
 
-   if (options & CompressionZlib)
-      output = new ozstream(output);
+   if (m_chunk_size)
+   {
+      m_file = output;
+      m_file_position = sizeof(hdr);
+      startChunk();
+   }
+   else
+      output = openCompression(output);
+}
+
+vostream *Sift::Writer::openCompression(vostream *stream)
+{
+   // A compression level of zero selects the codec's default
+#if SIFT_USE_ZLIB
+   if (m_options & CompressionZlib)
+      return m_compression_level ? new ozstream(stream, m_compression_level) : new ozstream(stream);
+#endif
+#if SIFT_USE_ZSTD
+   if (m_options & CompressionZstd)
+      return m_compression_level ? new ozstdstream(stream, m_compression_level) : new ozstdstream(stream);
+#endif
+#if SIFT_USE_LZ4
+   if (m_options & CompressionLz4)
+      return new olz4stream(stream, m_compression_level);
+#endif
+   return stream;
+}
+
+void Sift::Writer::startChunk()
+{
+   #if VERBOSE > 0
+   std::cerr << "[DEBUG:" << m_id << "] Start Chunk " << m_index.size() << " at " << ninstrs << " instructions" << std::endl;
+   #endif
+
+   IndexEntry entry = { ninstrs, m_file_position, last_address, m_isa, 0 };
+   m_index.push_back(entry);
+
+   // Every chunk must be decodable on its own: send icache pages and address mappings again when they are first used
+   icache.clear();
+   m_va2pa.clear();
+
+   output = openCompression(new vorefstream(m_file, &m_file_position));
 }
 
 // Modified from http://stackoverflow.com/questions/2203159/is-there-a-c-equivalent-to-getcwd
@@ -150,6 +216,15 @@ void Sift::Writer::End()
       delete output;
       output = NULL;
    }
+
+   if (m_file)
+   {
+      IndexTrailer trailer = { m_file_position, m_index.size(), IndexMagicNumber };
+      m_file->write(reinterpret_cast<char*>(&m_index[0]), m_index.size() * sizeof(IndexEntry));
+      m_file->write(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+      delete m_file;
+      m_file = NULL;
+   }
 }
 
 Sift::Writer::~Writer()
@@ -180,6 +255,18 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
       return;
    }
 
+   if (m_chunk_size && ninstrs == m_index.back().icount + m_chunk_size)
+   {
+      Record rec;
+      rec.Other.zero = 0;
+      rec.Other.type = RecOtherChunkEnd;
+      rec.Other.size = 0;
+      output->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+      // Flush the compressor, this updates m_file_position to the end of the chunk
+      delete output;
+      startChunk();
+   }
+
    if (m_requires_icache_per_insn)
    {
       if (! icache[addr])
@@ -889,6 +976,8 @@ void Sift::Writer::ISAChange(uint32_t new_isa)
 
    output->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
    output->write(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
+
+   m_isa = new_isa;
 }
 
 bool Sift::Writer::IsOpen()
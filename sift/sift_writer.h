@@ -5,6 +5,7 @@
 #include "sift_format.h"
 
 #include <unordered_map>
+#include <vector>
 #include <fstream>
 #include <assert.h>
 
@@ -37,14 +38,28 @@ namespace Sift
          uint32_t m_id;
          bool m_requires_icache_per_insn;
          bool m_send_va2pa_mapping;
+         uint64_t m_options;
+         int m_compression_level;
+         uint32_t m_isa;
+
+         // Indexed traces: output writes (and compresses) the current chunk into m_file
+         vostream *m_file;
+         uint64_t m_file_position;
+         uint64_t m_chunk_size;
+         std::vector<IndexEntry> m_index;
 
          void initResponse();
+         vostream *openCompression(vostream *stream);
+         void startChunk();
          void handleMemoryRequest(Record &respRec);
          void send_va2pa(uint64_t va);
          uint64_t va2pa_lookup(uint64_t va);
 
       public:
-         Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression = false, const char *response_filename = "", uint32_t id = 0, bool arch32 = false, bool requires_icache_per_insn = false, bool send_va2pa_mapping = false, GetCodeFunc2 getCodeFunc2 = NULL, void *GetCodeFunc2Data = NULL);
+         // compression: 0 (none), or one of CompressionZlib, CompressionZstd or CompressionLz4 (true selects zlib)
+         // compression_level: codec-specific, 0 selects the codec's default
+         // index_chunk_size: write an indexed, seekable trace with a new chunk every index_chunk_size instructions (0 = not indexed)
+         Writer(const char *filename, GetCodeFunc getCodeFunc, uint64_t compression = 0, const char *response_filename = "", uint32_t id = 0, bool arch32 = false, bool requires_icache_per_insn = false, bool send_va2pa_mapping = false, GetCodeFunc2 getCodeFunc2 = NULL, void *GetCodeFunc2Data = NULL, int compression_level = 0, uint64_t index_chunk_size = 0);
          ~Writer();
          void End();
          void Instruction(uint64_t addr, uint8_t size, uint8_t num_addresses, uint64_t addresses[], bool is_branch, bool taken, bool is_predicate, bool executed);
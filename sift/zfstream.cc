@@ -1,10 +1,12 @@
 #include "zfstream.h"
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 
 #if !SIFT_USE_ZLIB
 
-ozstream::ozstream(vostream *output)
+ozstream::ozstream(vostream *output, int level)
    : output(output)
 {
    assert(false);
@@ -47,7 +49,7 @@ int izstream::peek()
 
 #include <zlib.h>
 
-ozstream::ozstream(vostream *output)
+ozstream::ozstream(vostream *output, int level)
    : output(output)
 {
    zstream.zalloc = Z_NULL;
@@ -160,3 +162,233 @@ int izstream::peek()
 }
 
 #endif /*SIFT_USE_ZLIB*/
+
+
+
+#if SIFT_USE_ZSTD
+
+ozstdstream::ozstdstream(vostream *output, int level)
+   : output(output)
+{
+   zstream = ZSTD_createCStream();
+   assert(zstream);
+   size_t ret = ZSTD_initCStream(zstream, level);
+   assert(!ZSTD_isError(ret));
+}
+
+ozstdstream::~ozstdstream()
+{
+   size_t remaining;
+   do
+   {
+      ZSTD_outBuffer out = { buffer, chunksize, 0 };
+      remaining = ZSTD_endStream(zstream, &out);
+      assert(!ZSTD_isError(remaining));
+      output->write(buffer, out.pos);
+   } while(remaining > 0);
+   ZSTD_freeCStream(zstream);
+   delete output;
+}
+
+void ozstdstream::write(const char* s, std::streamsize n)
+{
+   ZSTD_inBuffer in = { s, size_t(n), 0 };
+   while(in.pos < in.size)
+   {
+      ZSTD_outBuffer out = { buffer, chunksize, 0 };
+      size_t ret = ZSTD_compressStream(zstream, &out, &in);
+      assert(!ZSTD_isError(ret));
+      output->write(buffer, out.pos);
+   }
+}
+
+izstdstream::izstdstream(vistream *input)
+   : input(input)
+   , m_eof(false)
+   , m_fail(false)
+   , peek_valid(false)
+{
+   zstream = ZSTD_createDStream();
+   assert(zstream);
+   size_t ret = ZSTD_initDStream(zstream);
+   assert(!ZSTD_isError(ret));
+   inbuf.src = buffer;
+   inbuf.size = 0;
+   inbuf.pos = 0;
+}
+
+izstdstream::~izstdstream()
+{
+   ZSTD_freeDStream(zstream);
+   delete input;
+}
+
+void izstdstream::read(char* s, std::streamsize n)
+{
+   if (peek_valid)
+   {
+      s[0] = peek_value;
+      peek_valid = false;
+      ++s;
+      --n;
+   }
+   if (n == 0)
+      return;
+   if (m_eof)
+   {
+      m_fail = true;
+      return;
+   }
+
+   ZSTD_outBuffer out = { s, size_t(n), 0 };
+   do
+   {
+      if (inbuf.pos == inbuf.size) // If input data was left over from the previous call, use that up first
+      {
+         input->read(buffer, chunksize);
+         inbuf.size = chunksize;
+         inbuf.pos = 0;
+      }
+      size_t ret = ZSTD_decompressStream(zstream, &out, &inbuf);
+      assert(!ZSTD_isError(ret));
+      if (ret == 0) // Frame completely decoded and flushed
+      {
+         m_eof = true;
+         if (out.pos < out.size)
+            m_fail = true;
+         return;
+      }
+   } while(out.pos < out.size);
+}
+
+int izstdstream::peek()
+{
+   if (peek_valid == true)
+      return peek_value;
+
+   read(&peek_value, 1);
+   peek_valid = true;
+
+   return peek_value;
+}
+
+#endif /*SIFT_USE_ZSTD*/
+
+
+
+#if SIFT_USE_LZ4
+
+olz4stream::olz4stream(vostream *output, int level)
+   : output(output)
+{
+   memset(&prefs, 0, sizeof(prefs));
+   prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+   prefs.compressionLevel = level;
+
+   size_t ret = LZ4F_createCompressionContext(&lz4ctx, LZ4F_VERSION);
+   assert(!LZ4F_isError(ret));
+
+   buffersize = LZ4F_compressBound(chunksize, &prefs);
+   if (buffersize < LZ4F_HEADER_SIZE_MAX)
+      buffersize = LZ4F_HEADER_SIZE_MAX;
+   buffer = new char[buffersize];
+
+   size_t size = LZ4F_compressBegin(lz4ctx, buffer, buffersize, &prefs);
+   assert(!LZ4F_isError(size));
+   output->write(buffer, size);
+}
+
+olz4stream::~olz4stream()
+{
+   size_t size = LZ4F_compressEnd(lz4ctx, buffer, buffersize, NULL);
+   assert(!LZ4F_isError(size));
+   output->write(buffer, size);
+   LZ4F_freeCompressionContext(lz4ctx);
+   delete [] buffer;
+   delete output;
+}
+
+void olz4stream::write(const char* s, std::streamsize n)
+{
+   while(n > 0)
+   {
+      size_t todo = std::min(size_t(n), chunksize);
+      size_t size = LZ4F_compressUpdate(lz4ctx, buffer, buffersize, s, todo, NULL);
+      assert(!LZ4F_isError(size));
+      output->write(buffer, size);
+      s += todo;
+      n -= todo;
+   }
+}
+
+ilz4stream::ilz4stream(vistream *input)
+   : input(input)
+   , m_eof(false)
+   , m_fail(false)
+   , buffer_pos(0)
+   , buffer_size(0)
+   , peek_valid(false)
+{
+   size_t ret = LZ4F_createDecompressionContext(&lz4ctx, LZ4F_VERSION);
+   assert(!LZ4F_isError(ret));
+}
+
+ilz4stream::~ilz4stream()
+{
+   LZ4F_freeDecompressionContext(lz4ctx);
+   delete input;
+}
+
+void ilz4stream::read(char* s, std::streamsize n)
+{
+   if (peek_valid)
+   {
+      s[0] = peek_value;
+      peek_valid = false;
+      ++s;
+      --n;
+   }
+   if (n == 0)
+      return;
+   if (m_eof)
+   {
+      m_fail = true;
+      return;
+   }
+
+   do
+   {
+      if (buffer_pos == buffer_size) // If input data was left over from the previous call, use that up first
+      {
+         input->read(buffer, chunksize);
+         buffer_size = chunksize;
+         buffer_pos = 0;
+      }
+      size_t dst_size = n, src_size = buffer_size - buffer_pos;
+      size_t ret = LZ4F_decompress(lz4ctx, s, &dst_size, buffer + buffer_pos, &src_size, NULL);
+      assert(!LZ4F_isError(ret));
+      buffer_pos += src_size;
+      s += dst_size;
+      n -= dst_size;
+      if (ret == 0) // End of frame
+      {
+         m_eof = true;
+         if (n)
+            m_fail = true;
+         return;
+      }
+   } while(n != 0);
+}
+
+int ilz4stream::peek()
+{
+   if (peek_valid == true)
+      return peek_value;
+
+   read(&peek_value, 1);
+   peek_valid = true;
+
+   return peek_value;
+}
+
+#endif /*SIFT_USE_LZ4*/
@@ -6,10 +6,17 @@
 #include <ostream>
 #include <istream>
 #include <fstream>
+#include <cstring>
 
 #if SIFT_USE_ZLIB
 # include <zlib.h>
 #endif
+#if SIFT_USE_ZSTD
+# include <zstd.h>
+#endif
+#if SIFT_USE_LZ4
+# include <lz4frame.h>
+#endif
 
 class vostream
 {
@@ -41,6 +48,26 @@ class vofstream : public vostream
          { return stream->is_open(); }
 };
 
+// Writes to a stream without taking ownership of it, and keeps track of the number of bytes written.
+// Used to write independently compressed chunks to the same file.
+class vorefstream : public vostream
+{
+   private:
+      vostream *stream;
+      uint64_t *position;
+   public:
+      vorefstream(vostream *stream, uint64_t *position)
+         : stream(stream), position(position) {}
+      virtual void write(const char* s, std::streamsize n)
+         { stream->write(s, n); *position += n; }
+      virtual void flush()
+         { stream->flush(); }
+      virtual bool fail()
+         { return stream->fail(); }
+      virtual bool is_open()
+         { return stream->is_open(); }
+};
+
 class ozstream : public vostream
 {
    private:
@@ -49,11 +76,10 @@ class ozstream : public vostream
       z_stream zstream;
 #endif
       static const size_t chunksize = 64*1024;
-      static const int level = 9;
       char buffer[chunksize];
       void doCompress(bool finish);
    public:
-      ozstream(vostream *output);
+      ozstream(vostream *output, int level = 9);
       virtual ~ozstream();
       virtual void write(const char* s, std::streamsize n);
       virtual void flush()
@@ -66,6 +92,52 @@ class ozstream : public vostream
 
 
 
+#if SIFT_USE_ZSTD
+class ozstdstream : public vostream
+{
+   private:
+      vostream *output;
+      ZSTD_CStream *zstream;
+      static const size_t chunksize = 64*1024;
+      char buffer[chunksize];
+   public:
+      ozstdstream(vostream *output, int level = 3);
+      virtual ~ozstdstream();
+      virtual void write(const char* s, std::streamsize n);
+      virtual void flush()
+         { output->flush(); }
+      virtual bool fail()
+         { return output->fail(); }
+      virtual bool is_open()
+         { return output->is_open(); }
+};
+#endif
+
+#if SIFT_USE_LZ4
+class olz4stream : public vostream
+{
+   private:
+      vostream *output;
+      LZ4F_compressionContext_t lz4ctx;
+      LZ4F_preferences_t prefs;
+      static const size_t chunksize = 64*1024;
+      char *buffer;        // Large enough to hold the compressed version of chunksize bytes
+      size_t buffersize;
+   public:
+      olz4stream(vostream *output, int level = 0);
+      virtual ~olz4stream();
+      virtual void write(const char* s, std::streamsize n);
+      virtual void flush()
+         { output->flush(); }
+      virtual bool fail()
+         { return output->fail(); }
+      virtual bool is_open()
+         { return output->is_open(); }
+};
+#endif
+
+
+
 class vistream
 {
    public:
@@ -92,6 +164,46 @@ class vifstream : public vistream
       virtual bool fail() const { return stream->fail(); }
 };
 
+// Reads from a stream without taking ownership of it
+class virefstream : public vistream
+{
+   private:
+      vistream *stream;
+   public:
+      virefstream(vistream *stream)
+         : stream(stream) {}
+      virtual void read(char* s, std::streamsize n)
+         { stream->read(s, n); }
+      virtual int peek()
+         { return stream->peek(); }
+      virtual bool fail() const { return stream->fail(); }
+};
+
+class vimemstream : public vistream
+{
+   private:
+      const char *m_data;
+      std::streamsize m_size;
+      std::streamsize m_pos;
+      bool m_fail;
+   public:
+      vimemstream(const char *data, std::streamsize size)
+         : m_data(data), m_size(size), m_pos(0), m_fail(false) {}
+      virtual void read(char* s, std::streamsize n)
+      {
+         if (n > m_size - m_pos)
+         {
+            n = m_size - m_pos;
+            m_fail = true;
+         }
+         memcpy(s, m_data + m_pos, n);
+         m_pos += n;
+      }
+      virtual int peek()
+         { return m_pos < m_size ? (unsigned char)m_data[m_pos] : EOF; }
+      virtual bool fail() const { return m_fail; }
+};
+
 class izstream : public vistream
 {
    private:
@@ -114,4 +226,50 @@ class izstream : public vistream
       virtual bool fail() const { return m_fail; }
 };
 
+#if SIFT_USE_ZSTD
+class izstdstream : public vistream
+{
+   private:
+      vistream *input;
+      bool m_eof;
+      bool m_fail;
+      ZSTD_DStream *zstream;
+      ZSTD_inBuffer inbuf;
+      static const size_t chunksize = 64*1024;
+      char buffer[chunksize];
+      char peek_value;
+      bool peek_valid;
+   public:
+      izstdstream(vistream *input);
+      virtual ~izstdstream();
+      virtual void read(char* s, std::streamsize n);
+      virtual int peek();
+      virtual bool eof() const { return m_eof; }
+      virtual bool fail() const { return m_fail; }
+};
+#endif
+
+#if SIFT_USE_LZ4
+class ilz4stream : public vistream
+{
+   private:
+      vistream *input;
+      bool m_eof;
+      bool m_fail;
+      LZ4F_decompressionContext_t lz4ctx;
+      static const size_t chunksize = 64*1024;
+      char buffer[chunksize];
+      size_t buffer_pos, buffer_size;
+      char peek_value;
+      bool peek_valid;
+   public:
+      ilz4stream(vistream *input);
+      virtual ~ilz4stream();
+      virtual void read(char* s, std::streamsize n);
+      virtual int peek();
+      virtual bool eof() const { return m_eof; }
+      virtual bool fail() const { return m_fail; }
+};
+#endif
+
 #endif // __ZFSTREAM_H
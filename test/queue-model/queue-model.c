@@ -0,0 +1,51 @@
+#include "sim_api.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Memory-bound kernel to compare the DRAM queue models: every thread does random read-modify-writes
+// over an array that is much larger than the last-level cache, so almost every access goes to DRAM.
+
+#define NUM_THREADS 4
+#define ARRAY_SIZE (64 * 1024 * 1024 / sizeof(long))
+#define NUM_ACCESSES 200000
+
+long *array;
+
+void * work(void * arg)
+{
+   unsigned long seed = (unsigned long)arg * 2654435761UL + 1;
+
+   for(int i = 0; i < NUM_ACCESSES; ++i)
+   {
+      seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+      array[(seed >> 17) % ARRAY_SIZE] += i;
+   }
+
+   return NULL;
+}
+
+int main()
+{
+   pthread_t threads[NUM_THREADS];
+
+   array = calloc(ARRAY_SIZE, sizeof(long));
+   if (!array)
+   {
+      perror("calloc");
+      return 1;
+   }
+
+   SimRoiStart();
+
+   for(long t = 0; t < NUM_THREADS; ++t)
+      pthread_create(&threads[t], NULL, work, (void*)t);
+   for(long t = 0; t < NUM_THREADS; ++t)
+      pthread_join(threads[t], NULL);
+
+   SimRoiEnd();
+
+   free(array);
+   return 0;
+}
@@ -0,0 +1,193 @@
+#!/usr/bin/env python
+
+# Reader for the DRAM access traces written with perf_model/dram/trace/enabled = true
+# (see common/core/memory_subsystem/dram/dram_trace.h for the file format)
+
+import sys, os, getopt, glob, gzip, struct
+
+HEADER = struct.Struct('<10I')
+RECORD = struct.Struct('<QQiIIIIHHHB5x')
+MAGIC = 0x31544453
+VERSION = 2
+MAPPINGS = [ 'vault_interleave', 'xor', 'page' ]
+ACCESS_TYPES = [ 'R', 'W' ]
+
+def usage():
+  print 'Usage:', sys.argv[0], '[-h (help)] [-d <resultsdir (default: .)> | <trace files>] [--dump] [--remap <mapping>[:<cubes>:<vaults_per_cube>:<banks_per_vault>:<block_size>:<page_size>]]'
+  print '  --dump: print all records instead of a summary'
+  print '  --remap: also report vault and bank balance under a different HMC address mapping (%s)' % ', '.join(MAPPINGS)
+
+
+class Trace:
+  def __init__(self, filename):
+    self.filename = filename
+    self.fp = gzip.open(filename, 'rb')
+    data = self.fp.read(HEADER.size)
+    if len(data) != HEADER.size:
+      raise ValueError('%s: truncated header' % filename)
+    magic, version, record_size, self.controller, self.num_cubes, self.vaults_per_cube, self.banks_per_vault, mapping, self.block_size, self.page_size = HEADER.unpack(data)
+    if magic != MAGIC:
+      raise ValueError('%s: not a DRAM trace' % filename)
+    if version != VERSION or record_size != RECORD.size:
+      raise ValueError('%s: unsupported DRAM trace version %d' % (filename, version))
+    self.mapping = MAPPINGS[mapping]
+
+  def __iter__(self):
+    chunk = 4096 * RECORD.size
+    while True:
+      data = self.fp.read(chunk)
+      for offset in range(0, len(data) - RECORD.size + 1, RECORD.size):
+        yield RECORD.unpack_from(data, offset)
+      if len(data) < chunk:
+        break
+
+
+def log2(value, name):
+  if value <= 0 or value & (value - 1):
+    raise ValueError('%s (%d) must be a power of two' % (name, value))
+  return value.bit_length() - 1
+
+class AddressMap:
+  # Mirrors HmcAddressMap in common/performance_model/hmc_address_map.h
+  def __init__(self, mapping, num_cubes, vaults_per_cube, banks_per_vault, block_size, page_size):
+    self.mapping = mapping
+    self.num_cubes = num_cubes
+    self.vaults_per_cube = vaults_per_cube
+    self.banks_per_vault = banks_per_vault
+    cube_bits = log2(num_cubes, 'cubes')
+    bank_bits = log2(banks_per_vault, 'banks_per_vault')
+    self.vault_bits = log2(vaults_per_cube, 'vaults_per_cube')
+    self.vault_shift = log2(page_size if mapping == 'page' else block_size, 'page_size' if mapping == 'page' else 'block_size')
+    self.cube_shift = self.vault_shift + self.vault_bits
+    self.bank_shift = self.cube_shift + cube_bits
+    self.row_shift = self.bank_shift + bank_bits
+    self.bank_xor_shift = self.row_shift + self.vault_bits
+    self.vault_mask = (1 << self.vault_bits) - 1
+    self.cube_mask = (1 << cube_bits) - 1
+    self.bank_mask = (1 << bank_bits) - 1
+    self.vault_xor_mask = self.vault_mask if mapping == 'xor' else 0
+    self.bank_xor_mask = self.bank_mask if mapping == 'xor' else 0
+
+  def vault(self, address):
+    vault = ((address >> self.vault_shift) ^ ((address >> self.row_shift) & self.vault_xor_mask)) & self.vault_mask
+    cube = (address >> self.cube_shift) & self.cube_mask
+    return (cube << self.vault_bits) | vault
+
+  def bank(self, address):
+    return ((address >> self.bank_shift) ^ ((address >> self.bank_xor_shift) & self.bank_xor_mask)) & self.bank_mask
+
+  def __str__(self):
+    return '%s, %d cube(s) x %d vaults x %d banks' % (self.mapping, self.num_cubes, self.vaults_per_cube, self.banks_per_vault)
+
+
+class Histogram:
+  def __init__(self, size):
+    self.counts = [ 0 ] * size
+
+  def add(self, index):
+    self.counts[index] += 1
+
+  def report(self, title):
+    total = sum(self.counts)
+    if not total:
+      return
+    mean = total / float(len(self.counts))
+    used = len([ c for c in self.counts if c ])
+    print '  %-24s %d of %d used, max/mean = %.2f' % (title, used, len(self.counts), max(self.counts) / mean)
+
+
+def summarize(traces, remap):
+  first = traces[0]
+  addrmap = AddressMap(first.mapping, first.num_cubes, first.vaults_per_cube, first.banks_per_vault, first.block_size, first.page_size)
+  vaults = Histogram(addrmap.num_cubes * addrmap.vaults_per_cube)
+  banks = Histogram(len(vaults.counts) * addrmap.banks_per_vault)
+  if remap:
+    remap_vaults = Histogram(remap.num_cubes * remap.vaults_per_cube)
+    remap_banks = Histogram(len(remap_vaults.counts) * remap.banks_per_vault)
+
+  for trace in traces:
+    count = [ 0, 0 ]
+    latency, queue, bus, device = 0, 0, 0, 0
+    time_min, time_max = None, None
+    for time, address, requester, lat, q, b, d, controller, vault, bank, type in trace:
+      count[type] += 1
+      latency += lat; queue += q; bus += b; device += d
+      if time_min is None or time < time_min: time_min = time
+      if time_max is None or time > time_max: time_max = time
+      vaults.add(vault)
+      banks.add(vault * addrmap.banks_per_vault + bank)
+      if remap:
+        remap_vault = remap.vault(address)
+        remap_vaults.add(remap_vault)
+        remap_banks.add(remap_vault * remap.banks_per_vault + remap.bank(address))
+
+    total = sum(count)
+    print 'Controller %d: %d accesses (%d reads, %d writes)' % (trace.controller, total, count[0], count[1]),
+    if total:
+      print 'from %.1f ns to %.1f ns' % (time_min / 1e6, time_max / 1e6)
+      print '  average latency %.2f ns (queue %.2f ns, bus %.2f ns, device %.2f ns)' % tuple([ v / 1e3 / total for v in (latency, queue, bus, device) ])
+    else:
+      print
+
+  print 'Vault balance as simulated (%s):' % addrmap
+  vaults.report('vaults')
+  banks.report('banks')
+  if remap:
+    print 'Vault balance when remapped (%s):' % remap
+    remap_vaults.report('vaults')
+    remap_banks.report('banks')
+
+
+def dump(traces, remap):
+  print 'time_fs,address,requester,type,controller,vault,bank,latency_ps,queue_ps,bus_ps,device_ps' + (',remap_vault,remap_bank' if remap else '')
+  for trace in traces:
+    for time, address, requester, lat, q, b, d, controller, vault, bank, type in trace:
+      line = '%d,0x%x,%d,%s,%d,%d,%d,%d,%d,%d,%d' % (time, address, requester, ACCESS_TYPES[type], controller, vault, bank, lat, q, b, d)
+      if remap:
+        line += ',%d,%d' % (remap.vault(address), remap.bank(address))
+      print line
+
+
+if __name__ == '__main__':
+  resultsdir = '.'
+  do_dump = False
+  remap = None
+
+  try:
+    opts, args = getopt.getopt(sys.argv[1:], "hd:", [ 'dump', 'remap=' ])
+  except getopt.GetoptError, e:
+    print e
+    usage()
+    sys.exit(-1)
+  for o, a in opts:
+    if o == '-h':
+      usage()
+      sys.exit()
+    if o == '-d':
+      resultsdir = a
+    if o == '--dump':
+      do_dump = True
+    if o == '--remap':
+      remap = a.split(':')
+
+  filenames = args or sorted(glob.glob(os.path.join(resultsdir, 'dram-trace-*.bin.gz')), key = lambda f: int(f.split('-')[-1].split('.')[0]))
+  if not filenames:
+    sys.stderr.write('No DRAM traces found in %s\n' % resultsdir)
+    sys.exit(-1)
+
+  try:
+    traces = [ Trace(filename) for filename in filenames ]
+    if remap:
+      if remap[0] not in MAPPINGS:
+        raise ValueError('Invalid mapping %s' % remap[0])
+      geometry = [ traces[0].num_cubes, traces[0].vaults_per_cube, traces[0].banks_per_vault, traces[0].block_size, traces[0].page_size ]
+      geometry[:len(remap) - 1] = map(int, remap[1:])
+      remap = AddressMap(remap[0], *geometry)
+  except ValueError, e:
+    sys.stderr.write('%s\n' % e)
+    sys.exit(-1)
+
+  if do_dump:
+    dump(traces, remap)
+  else:
+    summarize(traces, remap)